@@ -0,0 +1,21 @@
+#ifndef CPU_APPLICATION_HPP
+#define CPU_APPLICATION_HPP
+
+#include "config.hpp"
+#include "framework.hpp"
+#include "window.hpp"
+
+namespace cpu {
+
+class Application : public impl::Application
+{
+public:
+    DLL_EXPORT static Ptr<Application> create() noexcept;
+
+private:
+    Application(const details::Rasterizer& rasterizer) noexcept;
+};
+
+} // namespace cpu
+
+#endif // CPU_APPLICATION_HPP
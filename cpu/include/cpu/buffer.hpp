@@ -0,0 +1,35 @@
+#ifndef CPU_BUFFER_HPP
+#define CPU_BUFFER_HPP
+
+#include "config.hpp"
+#include "framework.hpp"
+
+namespace cpu {
+
+enum class BufferUsage
+{
+      Vertex
+    , Index
+    , Storage
+};
+
+class BufferHandle : public impl::BufferHandle
+{
+protected:
+    BufferHandle() noexcept = default;
+};
+
+// the items live in impl::Buffer::storage_, there is no device copy to tell the usage to
+template<typename T>
+class Buffer : public BufferHandle, public impl::Buffer<T>
+{
+public:
+    DLL_EXPORT static Ptr<Buffer> create(BufferUsage usage, const typename impl::Buffer<T>::Container& items) noexcept;
+
+protected:
+    Buffer(const typename impl::Buffer<T>::Container& items) noexcept;
+};
+
+} // namespace cpu
+
+#endif // CPU_BUFFER_HPP
@@ -0,0 +1,69 @@
+#ifndef CPU_COMMAND_QUEUE
+#define CPU_COMMAND_QUEUE
+
+#include <vector>
+
+#include "framework.hpp"
+#include "geometry_pool.hpp"
+#include "pipeline.hpp"
+#include "rasterizer.hpp"
+#include "uniform_buffer_object.hpp"
+
+namespace cpu {
+
+class CommandQueue : public impl::CommandQueue
+{
+    friend class ClearCommand;
+    friend class DrawCommand;
+    friend class Window;
+
+public:
+    DLL_EXPORT static Ptr<CommandQueue> create(const impl::Pipeline& pipeline);
+    DLL_EXPORT void addCommand(impl::Command& command) override;
+
+private:
+    CommandQueue(details::Rasterizer& rasterizer) noexcept;
+
+private:
+    std::vector<impl::Command*> commands_;
+    details::Rasterizer&        rasterizer_;
+    const Pipeline*             bound_pipeline_ = nullptr;
+    const GeometryPoolHandle*   bound_geometry_ = nullptr;
+};
+
+class ClearCommand : public impl::Command
+{
+public:
+    DLL_EXPORT static Ptr<ClearCommand> create() noexcept;
+    DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
+
+private:
+    ClearCommand() = default;
+};
+
+class DrawCommand : public impl::DrawCommand
+{
+public:
+    DLL_EXPORT static Ptr<DrawCommand> create(
+          const impl::Pipeline&           pipeline
+        , const impl::GeometryPoolHandle& geometry
+        , const impl::GeometryRange&      range) noexcept;
+    DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
+
+    DrawData& drawData() { return draw_data_; }
+
+private:
+    DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry, const impl::GeometryRange& range) noexcept;
+
+private:
+    const Pipeline&           pipeline_;
+    const GeometryPoolHandle& geometry_;
+    const impl::GeometryRange range_;
+    uint32_t                  first_vertex_ = 0; // vertices the range references, only these are transformed
+    uint32_t                  vertex_count_ = 0;
+    DrawData                  draw_data_;
+};
+
+} // namespace cpu
+
+#endif // CPU_COMMAND_QUEUE
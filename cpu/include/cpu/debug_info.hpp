@@ -0,0 +1,20 @@
+#ifndef CPU_DEBUG_INFO_HPP
+#define CPU_DEBUG_INFO_HPP
+
+#include "framework.hpp"
+
+namespace cpu {
+
+// there is no driver to report anything, errors surface through util::handle_error as they happen
+class DebugInfo : public impl::DebugInfo
+{
+public:
+    DLL_EXPORT static Ptr<DebugInfo> create(const impl::Application&) noexcept;
+
+private:
+    DebugInfo() noexcept = default;
+};
+
+} // namespace cpu
+
+#endif // CPU_DEBUG_INFO_HPP
@@ -0,0 +1,36 @@
+#ifndef CPU_GEOMETRY_POOL_HPP
+#define CPU_GEOMETRY_POOL_HPP
+
+#include "framework.hpp"
+
+namespace cpu {
+
+// draws read straight from the containers of impl::GeometryPool
+class GeometryPoolHandle : public impl::GeometryPoolHandle
+{
+    friend class DrawCommand;
+
+protected:
+    GeometryPoolHandle() noexcept = default;
+
+protected:
+    // refreshed by every upload, adding geometry may move the containers
+    const std::byte* vertex_data_ = nullptr;
+    const uint32_t*  index_data_ = nullptr;
+};
+
+template<typename V>
+class GeometryPool : public GeometryPoolHandle, public impl::GeometryPool<V>
+{
+public:
+    DLL_EXPORT static Ptr<GeometryPool> create() noexcept;
+
+private:
+    GeometryPool() noexcept = default;
+
+    bool upload(size_t first_vertex, size_t first_index) override;
+};
+
+} // namespace cpu
+
+#endif // CPU_GEOMETRY_POOL_HPP
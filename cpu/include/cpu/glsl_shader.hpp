@@ -0,0 +1,32 @@
+#ifndef CPU_GLSL_SHADER_HPP
+#define CPU_GLSL_SHADER_HPP
+
+#include "framework.hpp"
+
+namespace cpu {
+
+enum class ShaderType
+{
+      Vertex
+    , Fragment
+    , Compute
+};
+
+// stands for the stage only, the rasterizer runs the C++ kernels in shaders.hpp instead of the GLSL source
+class GlslShader : public impl::GlslShader
+{
+    friend class Pipeline;
+
+public:
+    DLL_EXPORT static Ptr<GlslShader> create(ShaderType type, std::string_view path) noexcept;
+
+private:
+    GlslShader(ShaderType type) noexcept;
+
+private:
+    const ShaderType type_;
+};
+
+} // namespace cpu
+
+#endif // CPU_GLSL_SHADER_HPP
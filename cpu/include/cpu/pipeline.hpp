@@ -0,0 +1,33 @@
+#ifndef CPU_PIPELINE_HPP
+#define CPU_PIPELINE_HPP
+
+#include "framework.hpp"
+#include "glsl_shader.hpp"
+#include "rasterizer.hpp"
+
+namespace cpu {
+
+// fixed function state matches the other backends: no culling, depth test less with writes, no blending
+class Pipeline : public impl::Pipeline
+{
+    friend class DrawCommand;
+
+public:
+    DLL_EXPORT static Ptr<Pipeline> create() noexcept;
+
+    DLL_EXPORT void addShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants = {}) override;
+    DLL_EXPORT bool use(const impl::VertexDescription& description) override;
+
+private:
+    Pipeline() noexcept = default;
+
+private:
+    bool                       has_vertex_shader_ = false;
+    bool                       has_fragment_shader_ = false;
+    details::VertexLayout      vertex_layout_;
+    details::FragmentConstants fragment_constants_;
+};
+
+} // namespace cpu
+
+#endif // CPU_PIPELINE_HPP
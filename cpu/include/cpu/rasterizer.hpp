@@ -0,0 +1,150 @@
+#ifndef CPU_RASTERIZER_HPP
+#define CPU_RASTERIZER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "framework.hpp"
+#include "shaders.hpp"
+#include "thread_pool.hpp"
+
+namespace cpu {
+namespace details {
+
+struct VertexLayout
+{
+    uint32_t stride          = 0;
+    uint32_t position_offset = 0; // vec3
+    uint32_t color_offset    = 0; // vec4
+};
+
+// one draw as the rasterizer sees it, the geometry stays in the pool it was added to
+struct DrawState
+{
+    const std::byte*    vertices;
+    const uint32_t*     indices;
+    VertexLayout        layout;
+    FragmentConstants   constants;
+    impl::GeometryRange range;
+    uint32_t            first_vertex; // lowest vertex the range references, vertex offset included
+    uint32_t            vertex_count;
+    glm::mat4           mvp;
+};
+
+// a frame goes through three parallel passes: vertices are transformed, triangles are set up and binned into
+// screen tiles, then every tile is cleared and rasterized on its own; triangles keep their submission order in a tile
+class Rasterizer
+{
+public:
+    static constexpr uint32_t TileSize          = 64; // pixels, a multiple of 4
+    static constexpr uint32_t VerticesPerJob    = 4096;
+    static constexpr uint32_t TrianglesPerChunk = 2048;
+    static constexpr int32_t  SubpixelBits      = 4;
+    // triangles reaching further off screen are clipped, which keeps the edge functions of a tile row in 32 bits
+    static constexpr float    GuardBand         = 8192.0f; // pixels
+
+public:
+    // thread_count of 0 uses every core
+    static Ptr<Rasterizer> create(uint32_t width, uint32_t height, uint32_t thread_count) noexcept;
+
+    // pending draws are rasterized before the clear
+    void clear(const glm::vec4& color);
+    void draw(const DrawState& draw);
+    void flush();
+
+    // RGBA8 with red in the lowest byte, rows from bottom to top as glReadPixels returns them
+    const uint32_t* color() const { return color_.data(); }
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    uint32_t stride() const { return stride_; }
+    size_t threadCount() const { return thread_count_; }
+
+private:
+    struct Triangle
+    {
+        // coverage, exact integer edge functions over subpixel coordinates so pixels on a shared edge are drawn once:
+        // e_i(x, y) = a_i * x + b_i * y + c_i, positive inside; c_i is one lower for edges that do not own their pixels
+        std::array<int64_t, 3>   a, b, c;
+        // interpolation, barycentrics of vertices 1 and 2 as planes over pixel indices, vertex 0 gets the rest
+        std::array<float, 2>     la, lb, lc;
+        std::array<float, 3>     z;         // window depth, linear in screen space
+        std::array<float, 3>     inv_w;
+        std::array<glm::vec4, 3> pos;       // vertex outputs over w, for perspective correct interpolation
+        std::array<glm::vec4, 3> color;
+        int32_t                  min_x, min_y, max_x, max_y;
+    };
+
+    struct VertexJob
+    {
+        uint32_t draw;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    struct Chunk
+    {
+        uint32_t                           draw;
+        uint32_t                           first_triangle;
+        uint32_t                           triangle_count;
+        std::vector<Triangle>              triangles;
+        std::vector<std::vector<uint32_t>> bins; // per tile, indices into triangles
+    };
+
+private:
+    Rasterizer(uint32_t width, uint32_t height, size_t thread_count) noexcept;
+
+    // func(i) for every i below count, on the pool and the calling thread
+    template<typename F>
+    void parallelFor(size_t count, F&& func);
+
+    void shadeVertices(const VertexJob& job);
+    void setupTriangles(Chunk& chunk);
+    void clipTriangle(Chunk& chunk, const std::array<ClipVertex, 3>& vertices) const;
+    void addTriangle(Chunk& chunk, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2) const;
+    void rasterizeTile(uint32_t tile);
+    void rasterizeTriangle(const Triangle& triangle, const FragmentConstants& constants, int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+
+private:
+    const uint32_t          width_, height_, stride_;
+    const uint32_t          tiles_x_, tiles_y_;
+    const float             guard_x_, guard_y_; // guard band in normalized device coordinates
+    const size_t            thread_count_;
+    std::vector<uint32_t>   color_;
+    std::vector<float>      depth_;
+    MemoryStats::Allocation framebuffer_memory_;
+
+    Opt<glm::vec4>                       pending_clear_;
+    std::vector<DrawState>               draws_;
+    std::vector<std::vector<ClipVertex>> clip_vertices_; // per draw, starting at its first_vertex
+    std::vector<VertexJob>               vertex_jobs_;
+    std::vector<Chunk>                   chunks_;
+    util::thread_pool                    pool_; // last, workers are joined before the frame data goes away
+};
+
+template<typename F>
+void Rasterizer::parallelFor(size_t count, F&& func)
+{
+    std::atomic<size_t> next{ 0 };
+    const auto work = [&]() {
+        for (auto i = next++; i < count; i = next++) {
+            func(i);
+        }
+    };
+    std::vector<std::future<void>> workers{};
+    const auto worker_count = std::min(thread_count_, count);
+    workers.reserve(worker_count);
+    for (size_t i = 1; i < worker_count; ++i) {
+        workers.push_back(pool_.submit(work));
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.get();
+    }
+}
+
+} // namespace details
+} // namespace cpu
+
+#endif // CPU_RASTERIZER_HPP
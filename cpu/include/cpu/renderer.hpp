@@ -0,0 +1,18 @@
+#ifndef CPU_RENDERER_HPP
+#define CPU_RENDERER_HPP
+
+#include "renderer_def.hpp"
+
+namespace cpu {
+
+class Renderer : public impl::Renderer
+{
+public:
+    DLL_EXPORT static Ptr<impl::Renderer> create() noexcept;
+    DLL_EXPORT static impl::Window& getWindow() noexcept;
+    DLL_EXPORT void run() override;
+};
+
+} // namespace cpu
+
+#endif // CPU_RENDERER_HPP
\ No newline at end of file
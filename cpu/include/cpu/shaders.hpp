@@ -0,0 +1,49 @@
+#ifndef CPU_SHADERS_HPP
+#define CPU_SHADERS_HPP
+
+#include <array>
+
+#include <glm/glm.hpp>
+#include "simd.hpp"
+
+namespace cpu {
+namespace details {
+
+// glsl/vertex.vert and glsl/fragment.frag written out in C++, the rasterizer runs these instead of the GLSL sources
+
+struct ClipVertex
+{
+    glm::vec4 pos;   // out_pos
+    glm::vec4 color; // out_color
+};
+
+// the specialization constants of fragment.frag, defaults as in the shader
+struct FragmentConstants
+{
+    bool  distance_shading = true;
+    float distance_scale   = 100.0f;
+};
+
+inline ClipVertex vertexShader(const glm::mat4& mvp, const glm::vec3& position, const glm::vec4& color)
+{
+    return { mvp * glm::vec4(position[0], position[1], position[2], 1.0f), color };
+}
+
+// four fragments at once, pos and color are the interpolated outputs of the vertex shader; color is shaded in place
+inline void fragmentShader(const FragmentConstants& constants, const std::array<simd::Float4, 4>& pos, std::array<simd::Float4, 4>& color)
+{
+    if (!constants.distance_shading) {
+        return;
+    }
+    // distance(fPos, vec4(0.0, 0.0, 0.0, 1.0)) / distance_scale
+    const simd::Float4 w = pos[3] - 1.0f;
+    const simd::Float4 scale = simd::sqrt(pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2] + w * w) / constants.distance_scale;
+    for (auto& channel : color) {
+        channel = channel * scale;
+    }
+}
+
+} // namespace details
+} // namespace cpu
+
+#endif // CPU_SHADERS_HPP
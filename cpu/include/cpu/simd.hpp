@@ -0,0 +1,150 @@
+#ifndef CPU_SIMD_HPP
+#define CPU_SIMD_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPU_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace cpu {
+namespace simd {
+
+// four pixels of one row at a time, SSE2 where the target has it and plain loops otherwise
+
+#ifdef CPU_SIMD_SSE2
+
+struct Mask4
+{
+    __m128 v;
+
+    bool any() const { return _mm_movemask_ps(v) != 0; }
+    Mask4 operator&(Mask4 o) const { return { _mm_and_ps(v, o.v) }; }
+};
+
+struct Float4
+{
+    __m128 v;
+
+    Float4() = default;
+    Float4(__m128 value) : v{ value } {}
+    Float4(float value) : v{ _mm_set1_ps(value) } {}
+
+    static Float4 ramp(float first) { return _mm_setr_ps(first, first + 1.0f, first + 2.0f, first + 3.0f); }
+    static Float4 load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    Float4 operator+(Float4 o) const { return _mm_add_ps(v, o.v); }
+    Float4 operator-(Float4 o) const { return _mm_sub_ps(v, o.v); }
+    Float4 operator*(Float4 o) const { return _mm_mul_ps(v, o.v); }
+    Float4 operator/(Float4 o) const { return _mm_div_ps(v, o.v); }
+
+    Mask4 operator<(Float4 o) const { return { _mm_cmplt_ps(v, o.v) }; }
+    Mask4 operator>(Float4 o) const { return { _mm_cmpgt_ps(v, o.v) }; }
+    Mask4 operator>=(Float4 o) const { return { _mm_cmpge_ps(v, o.v) }; }
+};
+
+struct Int4
+{
+    __m128i v;
+
+    Int4() = default;
+    Int4(__m128i value) : v{ value } {}
+    explicit Int4(int32_t value) : v{ _mm_set1_epi32(value) } {}
+
+    static Int4 ramp(int32_t first, int32_t step) { return _mm_setr_epi32(first, first + step, first + 2 * step, first + 3 * step); }
+
+    Int4 operator+(Int4 o) const { return _mm_add_epi32(v, o.v); }
+    Mask4 operator>(Int4 o) const { return { _mm_castsi128_ps(_mm_cmpgt_epi32(v, o.v)) }; }
+};
+
+inline Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+inline Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+inline Float4 select(Mask4 m, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)); }
+
+// channels in [0, 1] to RGBA8, red in the lowest byte
+inline void storeRgba8(Mask4 m, Float4 r, Float4 g, Float4 b, Float4 a, uint32_t* p)
+{
+    const auto to_byte = [](Float4 c) { return _mm_cvtps_epi32((min(max(c, 0.0f), 1.0f) * 255.0f).v); };
+    const __m128i rgba = _mm_or_si128(
+          _mm_or_si128(to_byte(r), _mm_slli_epi32(to_byte(g), 8))
+        , _mm_or_si128(_mm_slli_epi32(to_byte(b), 16), _mm_slli_epi32(to_byte(a), 24)));
+    const __m128i mask = _mm_castps_si128(m.v);
+    const __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_or_si128(_mm_and_si128(mask, rgba), _mm_andnot_si128(mask, old)));
+}
+
+#else
+
+struct Mask4
+{
+    std::array<bool, 4> v;
+
+    bool any() const { return v[0] || v[1] || v[2] || v[3]; }
+    Mask4 operator&(Mask4 o) const { return { v[0] && o.v[0], v[1] && o.v[1], v[2] && o.v[2], v[3] && o.v[3] }; }
+};
+
+struct Float4
+{
+    std::array<float, 4> v;
+
+    Float4() = default;
+    Float4(float value) : v{ value, value, value, value } {}
+
+    static Float4 ramp(float first) { Float4 r; for (int i = 0; i != 4; ++i) r.v[i] = first + i; return r; }
+    static Float4 load(const float* p) { Float4 r; for (int i = 0; i != 4; ++i) r.v[i] = p[i]; return r; }
+    void store(float* p) const { for (int i = 0; i != 4; ++i) p[i] = v[i]; }
+
+    template<typename Op>
+    Float4 apply(Float4 o, Op op) const { Float4 r; for (int i = 0; i != 4; ++i) r.v[i] = op(v[i], o.v[i]); return r; }
+    template<typename Op>
+    Mask4 compare(Float4 o, Op op) const { Mask4 r; for (int i = 0; i != 4; ++i) r.v[i] = op(v[i], o.v[i]); return r; }
+
+    Float4 operator+(Float4 o) const { return apply(o, [](float a, float b) { return a + b; }); }
+    Float4 operator-(Float4 o) const { return apply(o, [](float a, float b) { return a - b; }); }
+    Float4 operator*(Float4 o) const { return apply(o, [](float a, float b) { return a * b; }); }
+    Float4 operator/(Float4 o) const { return apply(o, [](float a, float b) { return a / b; }); }
+
+    Mask4 operator<(Float4 o) const { return compare(o, [](float a, float b) { return a < b; }); }
+    Mask4 operator>(Float4 o) const { return compare(o, [](float a, float b) { return a > b; }); }
+    Mask4 operator>=(Float4 o) const { return compare(o, [](float a, float b) { return a >= b; }); }
+};
+
+struct Int4
+{
+    std::array<int32_t, 4> v;
+
+    Int4() = default;
+    explicit Int4(int32_t value) : v{ value, value, value, value } {}
+
+    static Int4 ramp(int32_t first, int32_t step) { Int4 r; for (int i = 0; i != 4; ++i) r.v[i] = first + i * step; return r; }
+
+    Int4 operator+(Int4 o) const { Int4 r; for (int i = 0; i != 4; ++i) r.v[i] = v[i] + o.v[i]; return r; }
+    Mask4 operator>(Int4 o) const { Mask4 r; for (int i = 0; i != 4; ++i) r.v[i] = v[i] > o.v[i]; return r; }
+};
+
+inline Float4 sqrt(Float4 a) { Float4 r; for (int i = 0; i != 4; ++i) r.v[i] = std::sqrt(a.v[i]); return r; }
+inline Float4 min(Float4 a, Float4 b) { return a.apply(b, [](float x, float y) { return x < y ? x : y; }); }
+inline Float4 max(Float4 a, Float4 b) { return a.apply(b, [](float x, float y) { return x > y ? x : y; }); }
+inline Float4 select(Mask4 m, Float4 a, Float4 b) { Float4 r; for (int i = 0; i != 4; ++i) r.v[i] = m.v[i] ? a.v[i] : b.v[i]; return r; }
+
+inline void storeRgba8(Mask4 m, Float4 r, Float4 g, Float4 b, Float4 a, uint32_t* p)
+{
+    const auto to_byte = [](float c) { return static_cast<uint32_t>(std::lround(std::fmin(std::fmax(c, 0.0f), 1.0f) * 255.0f)); };
+    for (int i = 0; i != 4; ++i) {
+        if (m.v[i]) {
+            p[i] = to_byte(r.v[i]) | (to_byte(g.v[i]) << 8) | (to_byte(b.v[i]) << 16) | (to_byte(a.v[i]) << 24);
+        }
+    }
+}
+
+#endif // CPU_SIMD_SSE2
+
+} // namespace simd
+} // namespace cpu
+
+#endif // CPU_SIMD_HPP
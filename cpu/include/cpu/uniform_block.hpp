@@ -0,0 +1,27 @@
+#ifndef CPU_UNIFORM_BLOCK_HPP
+#define CPU_UNIFORM_BLOCK_HPP
+
+#include "framework.hpp"
+
+namespace cpu {
+
+// the kernels get the MVP with every draw and read nothing else, the block stays where it is
+template<typename UBO>
+class UniformBlock : public impl::UniformBlock<UBO>, public impl::BufferHandle
+{
+public:
+    DLL_EXPORT static Ptr<UniformBlock> create(impl::GlslShader&, const char* uniform_block_name, uint32_t binding);
+
+    DLL_EXPORT void update() override;
+    DLL_EXPORT UBO& get() override;
+
+private:
+    UniformBlock() noexcept = default;
+
+private:
+    UBO ubo_;
+};
+
+} // namespace cpu
+
+#endif // CPU_UNIFORM_BLOCK_HPP
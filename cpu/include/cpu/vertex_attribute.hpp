@@ -0,0 +1,38 @@
+#ifndef CPU_VERTEX_ATTRIBUTE_HPP
+#define CPU_VERTEX_ATTRIBUTE_HPP
+
+#include <glm/glm.hpp>
+
+#include "framework.hpp"
+
+namespace cpu {
+namespace details {
+
+struct VertexAttributeFormat
+{
+    uint32_t location;
+    uint32_t offset;
+    uint32_t components; // floats
+    uint32_t stride;
+};
+
+} // namespace details
+
+class VertexAttribute : public impl::VertexAttribute
+{
+    friend class VertexDescription;
+
+public:
+    template<typename Struct, size_t N, typename T>
+    DLL_EXPORT static Ptr<VertexAttribute> create(uint32_t location, glm::vec<N, T, glm::defaultp> Struct::* attr) noexcept;
+
+private:
+    VertexAttribute(const details::VertexAttributeFormat& format) noexcept;
+
+private:
+    const details::VertexAttributeFormat format_;
+};
+
+} // namespace cpu
+
+#endif // CPU_VERTEX_ATTRIBUTE_HPP
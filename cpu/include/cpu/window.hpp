@@ -0,0 +1,34 @@
+#ifndef CPU_WINDOW_HPP
+#define CPU_WINDOW_HPP
+
+#include "framework.hpp"
+#include "rasterizer.hpp"
+
+namespace cpu {
+
+class Window : public impl::Window
+{
+    friend class Application;
+    friend class CommandQueue;
+
+public:
+    DLL_EXPORT static Ptr<Window> create(uint32_t width, uint32_t height, std::string_view title) noexcept;
+
+    DLL_EXPORT void swapFramebuffers(impl::CommandQueue& queue) override;
+
+    // the last frame, valid until the next swap
+    DLL_EXPORT const details::Rasterizer& framebuffer() const { return *rasterizer_; }
+
+private:
+    Window(uint32_t width, uint32_t height, std::string_view title, bool headless) noexcept;
+
+    // copies the frame into the window through the legacy OpenGL context GLFW creates by default
+    void present();
+
+private:
+    Ptr<details::Rasterizer> rasterizer_;
+};
+
+} // namespace cpu
+
+#endif // CPU_WINDOW_HPP
@@ -0,0 +1,23 @@
+#include "cpu/application.hpp"
+#include "cpu/renderer.hpp"
+
+namespace cpu {
+
+DLL_EXPORT Ptr<Application> Application::create() noexcept
+{
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    return Ptr<Application>{ new Application{ *window.rasterizer_ } };
+}
+
+Application::Application(const details::Rasterizer& rasterizer) noexcept
+{
+#ifdef CPU_SIMD_SSE2
+    constexpr std::string_view Simd = "SSE2";
+#else
+    constexpr std::string_view Simd = "scalar";
+#endif
+    std::cout << "CPU rasterizer: " << rasterizer.threadCount() << " threads, " << Simd << ", "
+              << details::Rasterizer::TileSize << "x" << details::Rasterizer::TileSize << " tiles\n";
+}
+
+} // namespace cpu
@@ -0,0 +1,84 @@
+#include <span>
+
+#include "cpu/command_queue.hpp"
+#include "cpu/renderer.hpp"
+#include "cpu/window.hpp"
+
+namespace cpu {
+
+DLL_EXPORT Ptr<CommandQueue> CommandQueue::create(const impl::Pipeline& pipeline)
+{
+    auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    return Ptr<CommandQueue>{ new CommandQueue{ *window.rasterizer_ } };
+}
+
+DLL_EXPORT void CommandQueue::addCommand(impl::Command& command)
+{
+    commands_.push_back(&command);
+}
+
+CommandQueue::CommandQueue(details::Rasterizer& rasterizer) noexcept
+    : rasterizer_{ rasterizer }
+{}
+
+DLL_EXPORT Ptr<ClearCommand> ClearCommand::create() noexcept
+{
+    return Ptr<ClearCommand>{ new ClearCommand{} };
+}
+
+DLL_EXPORT void ClearCommand::operator()(impl::CommandQueue& queue)
+{
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    auto clear_color = *Config::instance().get<std::vector, float>("clear_color");
+    for (auto& component : clear_color) {
+        component /= 256.0;
+    }
+    q.rasterizer_.clear(glm::vec4(clear_color[0], clear_color[1], clear_color[2], clear_color[3]));
+}
+
+DLL_EXPORT Ptr<DrawCommand> DrawCommand::create(
+      const impl::Pipeline&           pipeline
+    , const impl::GeometryPoolHandle& geometry
+    , const impl::GeometryRange&      range) noexcept
+{
+    return Ptr<DrawCommand>{ new DrawCommand{
+          dynamic_cast<const Pipeline&>(pipeline)
+        , dynamic_cast<const GeometryPoolHandle&>(geometry)
+        , range
+    } };
+}
+
+DLL_EXPORT void DrawCommand::operator()(impl::CommandQueue& queue)
+{
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    // nothing to bind, counted so the stats compare with the other backends
+    IGNORE(q.changeState(q.bound_pipeline_, &pipeline_, &impl::FrameStats::pipeline_binds));
+    IGNORE(q.changeState(q.bound_geometry_, &geometry_, &impl::FrameStats::buffer_binds));
+    q.countDraw(range_.index_count);
+    q.rasterizer_.draw({
+          geometry_.vertex_data_
+        , geometry_.index_data_
+        , pipeline_.vertex_layout_
+        , pipeline_.fragment_constants_
+        , range_
+        , first_vertex_
+        , vertex_count_
+        , draw_data_.mvp
+    });
+}
+
+DrawCommand::DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry, const impl::GeometryRange& range) noexcept
+    : impl::DrawCommand{ pipeline, geometry }
+    , pipeline_{ pipeline }
+    , geometry_{ geometry }
+    , range_{ range }
+{
+    if (range.index_count == 0) {
+        return;
+    }
+    const auto [min_index, max_index] = std::ranges::minmax(std::span{ geometry.index_data_ + range.first_index, range.index_count });
+    first_vertex_ = static_cast<uint32_t>(static_cast<int64_t>(min_index) + range.vertex_offset);
+    vertex_count_ = max_index - min_index + 1;
+}
+
+} // namespace cpu
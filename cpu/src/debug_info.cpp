@@ -0,0 +1,10 @@
+#include "cpu/debug_info.hpp"
+
+namespace cpu {
+
+DLL_EXPORT Ptr<DebugInfo> DebugInfo::create(const impl::Application&) noexcept
+{
+    return Ptr<DebugInfo>{ new DebugInfo{} };
+}
+
+} // namespace cpu
@@ -0,0 +1,23 @@
+#include "model.hpp"
+
+#include "cpu/geometry_pool.hpp"
+
+namespace cpu {
+
+template<typename V>
+DLL_EXPORT Ptr<GeometryPool<V>> GeometryPool<V>::create() noexcept
+{
+    return Ptr<GeometryPool>{ new GeometryPool{} };
+}
+
+template<typename V>
+bool GeometryPool<V>::upload(size_t first_vertex, size_t first_index)
+{
+    vertex_data_ = reinterpret_cast<const std::byte*>(impl::GeometryPool<V>::vertices_.data());
+    index_data_ = impl::GeometryPool<V>::indices_.data();
+    return true;
+}
+
+template class GeometryPool<Vertex>;
+
+} // namespace cpu
@@ -0,0 +1,17 @@
+#include "cpu/glsl_shader.hpp"
+
+namespace cpu {
+
+DLL_EXPORT Ptr<GlslShader> GlslShader::create(ShaderType type, std::string_view path) noexcept
+{
+    if (type == ShaderType::Compute) {
+        return util::handle_error() << "No compute kernel for " << path;
+    }
+    return Ptr<GlslShader>{ new GlslShader{ type } };
+}
+
+GlslShader::GlslShader(ShaderType type) noexcept
+    : type_{ type }
+{}
+
+} // namespace cpu
@@ -0,0 +1,54 @@
+#include "constants.h"
+
+#include "cpu/pipeline.hpp"
+#include "cpu/vertex_description.hpp"
+
+namespace cpu {
+
+DLL_EXPORT Ptr<Pipeline> Pipeline::create() noexcept
+{
+    return Ptr<Pipeline>{ new Pipeline{} };
+}
+
+DLL_EXPORT void Pipeline::addShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants)
+{
+    const auto& s = dynamic_cast<const GlslShader&>(shader);
+    if (s.type_ == ShaderType::Vertex) {
+        has_vertex_shader_ = true;
+        return;
+    }
+    has_fragment_shader_ = true;
+    for (const auto& [id, bits] : constants.values()) {
+        switch (id) {
+        case DISTANCE_SHADING_CONSTANT_ID:
+            fragment_constants_.distance_shading = bits != 0;
+            break;
+        case DISTANCE_SCALE_CONSTANT_ID:
+            fragment_constants_.distance_scale = std::bit_cast<float>(bits);
+            break;
+        default:
+            std::cout << "Unknown fragment specialization constant " << id << '\n';
+        }
+    }
+}
+
+DLL_EXPORT bool Pipeline::use(const impl::VertexDescription& description)
+{
+    if (!has_vertex_shader_ || !has_fragment_shader_) {
+        return util::handle_error() << "Pipeline needs a vertex and a fragment shader";
+    }
+    const auto& attributes = dynamic_cast<const VertexDescription&>(description).attributes_;
+    const auto find = [&](uint32_t location, uint32_t components) -> const details::VertexAttributeFormat* {
+        const auto it = std::ranges::find(attributes, location, &details::VertexAttributeFormat::location);
+        return it != attributes.end() && it->components == components ? &*it : nullptr;
+    };
+    const auto* position = find(VERTEX_POSITION_LOCATION, 3);
+    const auto* color = find(VERTEX_COLOR_LOCATION, 4);
+    if (!position || !color || position->stride != color->stride) {
+        return util::handle_error() << "The vertex kernel reads a vec3 position and a vec4 color from one vertex buffer";
+    }
+    vertex_layout_ = { position->stride, position->offset, color->offset };
+    return true;
+}
+
+} // namespace cpu
@@ -0,0 +1,362 @@
+#include <cmath>
+#include <cstring>
+
+#include "cpu/rasterizer.hpp"
+
+namespace cpu {
+namespace details {
+
+namespace {
+
+uint32_t packRgba8(const glm::vec4& color)
+{
+    const auto to_byte = [](float c) { return static_cast<uint32_t>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f)); };
+    return to_byte(color[0]) | (to_byte(color[1]) << 8) | (to_byte(color[2]) << 16) | (to_byte(color[3]) << 24);
+}
+
+ClipVertex lerp(const ClipVertex& a, const ClipVertex& b, float t)
+{
+    return { a.pos + (b.pos - a.pos) * t, a.color + (b.color - a.color) * t };
+}
+
+} // namespace
+
+Ptr<Rasterizer> Rasterizer::create(uint32_t width, uint32_t height, uint32_t thread_count) noexcept
+{
+    if (width == 0 || height == 0) {
+        return util::handle_error() << "Empty framebuffer " << width << 'x' << height;
+    }
+    const size_t threads = thread_count != 0 ? thread_count : std::max(std::thread::hardware_concurrency(), 1u);
+    return Ptr<Rasterizer>{ new Rasterizer{ width, height, threads } };
+}
+
+Rasterizer::Rasterizer(uint32_t width, uint32_t height, size_t thread_count) noexcept
+    : width_{ width }
+    , height_{ height }
+    , stride_{ (width + 3) & ~3u }
+    , tiles_x_{ (width + TileSize - 1) / TileSize }
+    , tiles_y_{ (height + TileSize - 1) / TileSize }
+    , guard_x_{ 2.0f * GuardBand / width }
+    , guard_y_{ 2.0f * GuardBand / height }
+    , thread_count_{ thread_count }
+    , color_(static_cast<size_t>(stride_) * height)
+    , depth_(static_cast<size_t>(stride_) * height, 1.0f)
+    , framebuffer_memory_{ MemoryStats::Heap::Host, MemoryStats::Category::Images, color_.size() * sizeof(uint32_t) + depth_.size() * sizeof(float) }
+    , pool_{ thread_count - 1 } // the thread calling flush works too
+{}
+
+void Rasterizer::clear(const glm::vec4& color)
+{
+    if (!draws_.empty()) {
+        flush();
+    }
+    pending_clear_ = color;
+}
+
+void Rasterizer::draw(const DrawState& draw)
+{
+    if (draw.range.index_count >= 3) {
+        draws_.push_back(draw);
+    }
+}
+
+void Rasterizer::flush()
+{
+    if (!pending_clear_ && draws_.empty()) {
+        return;
+    }
+
+    size_t chunk_count = 0;
+    clip_vertices_.resize(draws_.size());
+    vertex_jobs_.clear();
+    for (uint32_t d = 0; d != draws_.size(); ++d) {
+        const auto& draw = draws_[d];
+        clip_vertices_[d].resize(draw.vertex_count);
+        for (uint32_t first = 0; first < draw.vertex_count; first += VerticesPerJob) {
+            vertex_jobs_.push_back({ d, first, std::min(VerticesPerJob, draw.vertex_count - first) });
+        }
+        chunk_count += (draw.range.index_count / 3 + TrianglesPerChunk - 1) / TrianglesPerChunk;
+    }
+    parallelFor(vertex_jobs_.size(), [this](size_t i) { shadeVertices(vertex_jobs_[i]); });
+
+    chunks_.resize(chunk_count);
+    auto chunk = chunks_.begin();
+    for (uint32_t d = 0; d != draws_.size(); ++d) {
+        const uint32_t triangle_count = draws_[d].range.index_count / 3;
+        for (uint32_t first = 0; first < triangle_count; first += TrianglesPerChunk, ++chunk) {
+            chunk->draw = d;
+            chunk->first_triangle = first;
+            chunk->triangle_count = std::min(TrianglesPerChunk, triangle_count - first);
+        }
+    }
+    parallelFor(chunks_.size(), [this](size_t i) { setupTriangles(chunks_[i]); });
+
+    parallelFor(static_cast<size_t>(tiles_x_) * tiles_y_, [this](size_t i) { rasterizeTile(static_cast<uint32_t>(i)); });
+
+    pending_clear_.reset();
+    draws_.clear();
+}
+
+void Rasterizer::shadeVertices(const VertexJob& job)
+{
+    const auto& draw = draws_[job.draw];
+    auto* out = clip_vertices_[job.draw].data();
+    for (uint32_t i = job.first; i != job.first + job.count; ++i) {
+        const auto* vertex = draw.vertices + static_cast<size_t>(draw.first_vertex + i) * draw.layout.stride;
+        glm::vec3 position;
+        glm::vec4 color;
+        std::memcpy(&position, vertex + draw.layout.position_offset, sizeof(position));
+        std::memcpy(&color, vertex + draw.layout.color_offset, sizeof(color));
+        out[i] = vertexShader(draw.mvp, position, color);
+    }
+}
+
+void Rasterizer::setupTriangles(Chunk& chunk)
+{
+    chunk.triangles.clear();
+    chunk.bins.resize(static_cast<size_t>(tiles_x_) * tiles_y_);
+    for (auto& bin : chunk.bins) {
+        bin.clear();
+    }
+
+    const auto& draw = draws_[chunk.draw];
+    const auto& vertices = clip_vertices_[chunk.draw];
+    const auto* indices = draw.indices + draw.range.first_index + static_cast<size_t>(chunk.first_triangle) * 3;
+    const int64_t base = static_cast<int64_t>(draw.range.vertex_offset) - draw.first_vertex;
+    for (uint32_t t = 0; t != chunk.triangle_count; ++t, indices += 3) {
+        clipTriangle(chunk, { vertices[base + indices[0]], vertices[base + indices[1]], vertices[base + indices[2]] });
+    }
+}
+
+void Rasterizer::clipTriangle(Chunk& chunk, const std::array<ClipVertex, 3>& vertices) const
+{
+    // outside one of the clip planes as a whole
+    const auto outside = [&](auto&& test) {
+        return std::ranges::all_of(vertices, [&](const ClipVertex& v) { return test(v.pos); });
+    };
+    if (outside([](const glm::vec4& p) { return p[0] < -p[3]; }) || outside([](const glm::vec4& p) { return p[0] > p[3]; })
+        || outside([](const glm::vec4& p) { return p[1] < -p[3]; }) || outside([](const glm::vec4& p) { return p[1] > p[3]; })
+        || outside([](const glm::vec4& p) { return p[2] < 0.0f; }) || outside([](const glm::vec4& p) { return p[2] > p[3]; })) {
+        return;
+    }
+
+    // the near plane, z >= 0 with depth from zero to one also keeps w positive, and the guard band;
+    // the viewport and the far plane are left to the bounding box and the depth test
+    constexpr size_t ClipPlanes = 5;
+    const auto distance = [this](size_t plane, const glm::vec4& p) {
+        switch (plane) {
+        case 0:  return p[2];
+        case 1:  return guard_x_ * p[3] - p[0];
+        case 2:  return guard_x_ * p[3] + p[0];
+        case 3:  return guard_y_ * p[3] - p[1];
+        default: return guard_y_ * p[3] + p[1];
+        }
+    };
+    const auto inside = [&](const ClipVertex& v) {
+        for (size_t plane = 0; plane != ClipPlanes; ++plane) {
+            if (distance(plane, v.pos) < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (std::ranges::all_of(vertices, inside)) {
+        addTriangle(chunk, vertices[0], vertices[1], vertices[2]);
+        return;
+    }
+
+    // Sutherland-Hodgman, every plane adds at most one vertex
+    std::array<ClipVertex, 3 + ClipPlanes> polygon, clipped;
+    std::ranges::copy(vertices, polygon.begin());
+    size_t count = vertices.size();
+    for (size_t plane = 0; plane != ClipPlanes; ++plane) {
+        size_t clipped_count = 0;
+        for (size_t i = 0; i != count; ++i) {
+            const auto& a = polygon[i];
+            const auto& b = polygon[(i + 1) % count];
+            const auto da = distance(plane, a.pos), db = distance(plane, b.pos);
+            if (da >= 0.0f) {
+                clipped[clipped_count++] = a;
+            }
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                clipped[clipped_count++] = lerp(a, b, da / (da - db));
+            }
+        }
+        std::swap(polygon, clipped);
+        count = clipped_count;
+        if (count < 3) {
+            return;
+        }
+    }
+    for (size_t i = 2; i < count; ++i) {
+        addTriangle(chunk, polygon[0], polygon[i - 1], polygon[i]);
+    }
+}
+
+void Rasterizer::addTriangle(Chunk& chunk, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2) const
+{
+    constexpr double Subpixels = 1 << SubpixelBits;
+    constexpr int64_t HalfPixel = 1 << (SubpixelBits - 1);
+
+    const std::array<const ClipVertex*, 3> v = { &v0, &v1, &v2 };
+    Triangle tri;
+    std::array<int64_t, 3> x, y; // window coordinates snapped to subpixels
+    for (size_t i = 0; i != 3; ++i) {
+        tri.inv_w[i] = 1.0f / v[i]->pos[3];
+        x[i] = std::lround((v[i]->pos[0] * tri.inv_w[i] * 0.5f + 0.5f) * width_ * Subpixels);
+        y[i] = std::lround((v[i]->pos[1] * tri.inv_w[i] * 0.5f + 0.5f) * height_ * Subpixels);
+        tri.z[i] = v[i]->pos[2] * tri.inv_w[i];
+        tri.pos[i] = v[i]->pos * tri.inv_w[i];
+        tri.color[i] = v[i]->color * tri.inv_w[i];
+    }
+
+    // edge i is opposite vertex i
+    for (size_t i = 0; i != 3; ++i) {
+        const auto p = (i + 1) % 3, q = (i + 2) % 3;
+        tri.a[i] = y[p] - y[q];
+        tri.b[i] = x[q] - x[p];
+        tri.c[i] = -(tri.a[i] * x[p] + tri.b[i] * y[p]);
+    }
+    auto area = tri.a[0] * x[0] + tri.b[0] * y[0] + tri.c[0];
+    if (area == 0) {
+        return;
+    }
+    // culling is off, back faces are turned around so the inside is positive either way
+    if (area < 0) {
+        area = -area;
+        for (size_t i = 0; i != 3; ++i) {
+            tri.a[i] = -tri.a[i];
+            tri.b[i] = -tri.b[i];
+            tri.c[i] = -tri.c[i];
+        }
+    }
+    for (size_t i = 1; i != 3; ++i) {
+        // at the center of pixel (px, py): e_i(px * Subpixels + HalfPixel, py * Subpixels + HalfPixel) / area
+        const double inv_area = 1.0 / static_cast<double>(area);
+        tri.la[i - 1] = static_cast<float>(tri.a[i] * Subpixels * inv_area);
+        tri.lb[i - 1] = static_cast<float>(tri.b[i] * Subpixels * inv_area);
+        tri.lc[i - 1] = static_cast<float>((tri.a[i] * HalfPixel + tri.b[i] * HalfPixel + tri.c[i]) * inv_area);
+    }
+    // top-left rule, left edges and horizontal top edges own the pixels whose centers lie on them
+    for (size_t i = 0; i != 3; ++i) {
+        if (!(tri.a[i] > 0 || (tri.a[i] == 0 && tri.b[i] < 0))) {
+            --tri.c[i];
+        }
+    }
+
+    // pixels whose centers fall inside the bounds
+    const auto [min_x, max_x] = std::ranges::minmax(x);
+    const auto [min_y, max_y] = std::ranges::minmax(y);
+    const auto first_pixel = [](int64_t v) { return static_cast<int32_t>(-((HalfPixel - v) >> SubpixelBits)); };
+    const auto last_pixel = [](int64_t v) { return static_cast<int32_t>((v - HalfPixel) >> SubpixelBits); };
+    tri.min_x = std::max(first_pixel(min_x), 0);
+    tri.min_y = std::max(first_pixel(min_y), 0);
+    tri.max_x = std::min(last_pixel(max_x), static_cast<int32_t>(width_) - 1);
+    tri.max_y = std::min(last_pixel(max_y), static_cast<int32_t>(height_) - 1);
+    if (tri.min_x > tri.max_x || tri.min_y > tri.max_y) {
+        return;
+    }
+
+    const auto index = static_cast<uint32_t>(chunk.triangles.size());
+    chunk.triangles.push_back(tri);
+    for (uint32_t ty = tri.min_y / TileSize; ty <= tri.max_y / TileSize; ++ty) {
+        for (uint32_t tx = tri.min_x / TileSize; tx <= tri.max_x / TileSize; ++tx) {
+            chunk.bins[ty * tiles_x_ + tx].push_back(index);
+        }
+    }
+}
+
+void Rasterizer::rasterizeTile(uint32_t tile)
+{
+    const int32_t x0 = (tile % tiles_x_) * TileSize;
+    const int32_t y0 = (tile / tiles_x_) * TileSize;
+    const int32_t x1 = std::min(x0 + TileSize, width_) - 1;
+    const int32_t y1 = std::min(y0 + TileSize, height_) - 1;
+
+    if (pending_clear_) {
+        const auto color = packRgba8(*pending_clear_);
+        for (int32_t y = y0; y <= y1; ++y) {
+            const auto row = static_cast<size_t>(y) * stride_;
+            std::fill(color_.begin() + row + x0, color_.begin() + row + x1 + 1, color);
+            std::fill(depth_.begin() + row + x0, depth_.begin() + row + x1 + 1, 1.0f);
+        }
+    }
+
+    for (const auto& chunk : chunks_) {
+        const auto& constants = draws_[chunk.draw].constants;
+        for (const auto index : chunk.bins[tile]) {
+            const auto& tri = chunk.triangles[index];
+            rasterizeTriangle(tri, constants, std::max(x0, tri.min_x), std::max(y0, tri.min_y), std::min(x1, tri.max_x), std::min(y1, tri.max_y));
+        }
+    }
+}
+
+void Rasterizer::rasterizeTriangle(const Triangle& tri, const FragmentConstants& constants, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    using simd::Float4;
+    using simd::Int4;
+    using simd::Mask4;
+
+    constexpr int64_t Subpixels = 1 << SubpixelBits;
+    // a row of a tile changes an edge function by less than 2^29 within the guard band, so starting values
+    // clamped to 2^30 still fit and keep their sign over the row
+    constexpr int64_t RowLimit = 1 << 30;
+
+    const Int4 outside{ -1 };
+    const std::array<Int4, 3> group_step = {
+          Int4{ static_cast<int32_t>(tri.a[0] * Subpixels * 4) }
+        , Int4{ static_cast<int32_t>(tri.a[1] * Subpixels * 4) }
+        , Int4{ static_cast<int32_t>(tri.a[2] * Subpixels * 4) }
+    };
+
+    // groups of four start at a multiple of four, tiles and rows do too, so a group never leaves the tile;
+    // pixels of the group outside the bounds fail the edge tests, those past the width land in the row padding
+    const int32_t first_x = x0 & ~3;
+    for (int32_t y = y0; y <= y1; ++y) {
+        const int64_t sx = first_x * Subpixels + Subpixels / 2;
+        const int64_t sy = y * Subpixels + Subpixels / 2;
+        std::array<Int4, 3> edge;
+        for (size_t i = 0; i != 3; ++i) {
+            const auto row = std::clamp(tri.a[i] * sx + tri.b[i] * sy + tri.c[i], -RowLimit, RowLimit);
+            edge[i] = Int4::ramp(static_cast<int32_t>(row), static_cast<int32_t>(tri.a[i] * Subpixels));
+        }
+        const std::array<float, 2> row_l = { tri.lb[0] * y + tri.lc[0], tri.lb[1] * y + tri.lc[1] };
+        const auto row = static_cast<size_t>(y) * stride_;
+
+        for (int32_t x = first_x; x <= x1; x += 4) {
+            const Mask4 covered = (edge[0] > outside) & (edge[1] > outside) & (edge[2] > outside);
+            for (size_t i = 0; i != 3; ++i) {
+                edge[i] = edge[i] + group_step[i];
+            }
+            if (!covered.any()) {
+                continue;
+            }
+
+            const auto px = Float4::ramp(static_cast<float>(x));
+            const Float4 l1 = px * tri.la[0] + row_l[0];
+            const Float4 l2 = px * tri.la[1] + row_l[1];
+            const Float4 l0 = Float4(1.0f) - l1 - l2;
+
+            auto* depth = depth_.data() + row + x;
+            const auto z = l0 * tri.z[0] + l1 * tri.z[1] + l2 * tri.z[2];
+            const auto stored = Float4::load(depth);
+            const Mask4 mask = covered & (z < stored);
+            if (!mask.any()) {
+                continue;
+            }
+            simd::select(mask, z, stored).store(depth);
+
+            const auto w = Float4(1.0f) / (l0 * tri.inv_w[0] + l1 * tri.inv_w[1] + l2 * tri.inv_w[2]);
+            std::array<Float4, 4> pos, color;
+            for (glm::length_t c = 0; c != 4; ++c) {
+                pos[c] = (l0 * tri.pos[0][c] + l1 * tri.pos[1][c] + l2 * tri.pos[2][c]) * w;
+                color[c] = (l0 * tri.color[0][c] + l1 * tri.color[1][c] + l2 * tri.color[2][c]) * w;
+            }
+            fragmentShader(constants, pos, color);
+            simd::storeRgba8(mask, color[0], color[1], color[2], color[3], color_.data() + row + x);
+        }
+    }
+}
+
+} // namespace details
+} // namespace cpu
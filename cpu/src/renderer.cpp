@@ -0,0 +1,3 @@
+#define CPU
+#include "cpu/renderer.hpp"
+#include "renderer_impl.hpp"
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include "constants.h"
+#include "model.hpp"
+#include "trace.hpp"
+
+#include "cpu/uniform_block.hpp"
+
+namespace cpu {
+
+template<typename UBO>
+DLL_EXPORT Ptr<UniformBlock<UBO>> UniformBlock<UBO>::create(impl::GlslShader&, const char* uniform_block_name, uint32_t binding)
+{
+    return Ptr<UniformBlock>{ new UniformBlock{} };
+}
+
+template<typename UBO>
+DLL_EXPORT void UniformBlock<UBO>::update()
+{
+    TRACE_ZONE("UniformBlock::update");
+    // nothing to upload, uploadedBytes() stays zero
+}
+
+template<typename UBO>
+DLL_EXPORT UBO& UniformBlock<UBO>::get()
+{
+    return ubo_;
+}
+
+template class UniformBlock<UNIFORM_BUFFER_OBJECT>;
+
+} // namespace cpu
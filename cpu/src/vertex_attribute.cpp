@@ -0,0 +1,25 @@
+#include "cpu/vertex_attribute.hpp"
+#include "uniform_buffer_object.hpp"
+
+namespace cpu {
+
+template<typename Struct, size_t N, typename T>
+DLL_EXPORT Ptr<VertexAttribute> VertexAttribute::create(uint32_t location, glm::vec<N, T, glm::defaultp> Struct::* attr) noexcept
+{
+    static_assert(std::is_same_v<T, float>, "the vertex kernel reads float attributes only");
+    return Ptr<VertexAttribute>{ new VertexAttribute{ {
+          location
+        , util::field_offset<uint32_t>(attr)
+        , static_cast<uint32_t>(N)
+        , sizeof(Struct)
+    } } };
+}
+
+VertexAttribute::VertexAttribute(const details::VertexAttributeFormat& format) noexcept
+    : format_{ format }
+{}
+
+template DLL_EXPORT Ptr<VertexAttribute> VertexAttribute::create<Vertex, 3, float>(uint32_t, glm::vec3 Vertex::*) noexcept;
+template DLL_EXPORT Ptr<VertexAttribute> VertexAttribute::create<Vertex, 4, float>(uint32_t, glm::vec4 Vertex::*) noexcept;
+
+} // namespace cpu
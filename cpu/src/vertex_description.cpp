@@ -0,0 +1,15 @@
+#include "cpu/vertex_description.hpp"
+
+namespace cpu {
+
+DLL_EXPORT Ptr<VertexDescription> VertexDescription::create() noexcept
+{
+    return Ptr<VertexDescription>{ new VertexDescription{} };
+}
+
+DLL_EXPORT void VertexDescription::addAttribute(const impl::VertexAttribute& attribute)
+{
+    attributes_.push_back(dynamic_cast<const VertexAttribute&>(attribute).format_);
+}
+
+} // namespace cpu
@@ -0,0 +1,64 @@
+#include <glfw/glfw3.h>
+
+#include "trace.hpp"
+
+#include "cpu/command_queue.hpp"
+#include "cpu/window.hpp"
+
+namespace cpu {
+namespace {
+
+constexpr impl::Window::HintsList Hints = {
+      {GLFW_RESIZABLE, GLFW_FALSE}
+};
+
+} // namespace
+
+DLL_EXPORT Ptr<Window> Window::create(uint32_t width, uint32_t height, std::string_view title) noexcept
+{
+    const auto headless = Config::instance().get<bool>("headless").value_or(false);
+    auto window = Ptr<Window>{ new Window{width, height, title, headless} };
+    if (!headless) {
+        if (!window->window_) {
+            return util::handle_error() << getGlfwErrorDescription();
+        }
+        glfwMakeContextCurrent(window->window_.get());
+    }
+    window->rasterizer_ = details::Rasterizer::create(width, height, Config::instance().get<uint32_t>("cpu_threads").value_or(0));
+    if (!window->rasterizer_) {
+        return util::handle_error();
+    }
+    return window;
+}
+
+DLL_EXPORT void Window::swapFramebuffers(impl::CommandQueue& queue)
+{
+    TRACE_ZONE("Window::swapFramebuffers");
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    // binds are counted per frame like on the other backends, the first draw of a frame always binds
+    q.bound_pipeline_ = nullptr;
+    q.bound_geometry_ = nullptr;
+    q.sortCommands(q.commands_);
+    // commands only record, the frame is rasterized when it is flushed
+    for (const auto& command : q.commands_) {
+        (*command)(q);
+    }
+    rasterizer_->flush();
+    if (!headless_) {
+        present();
+    }
+}
+
+Window::Window(uint32_t width, uint32_t height, std::string_view title, bool headless) noexcept
+    : impl::Window{ width, height, title, Hints, headless }
+{}
+
+void Window::present()
+{
+    // rows are bottom to top like the default framebuffer, the raster position starts at its lower left corner
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rasterizer_->stride());
+    glDrawPixels(rasterizer_->width(), rasterizer_->height(), GL_RGBA, GL_UNSIGNED_BYTE, rasterizer_->color());
+    glfwSwapBuffers(window_.get());
+}
+
+} // namespace cpu
@@ -5,8 +5,14 @@ layout(location = VERTEX_COLOR_LOCATION) in vec4 fColor;
 
 layout(location = 0) out vec4 color;
 
+SPECIALIZATION_CONSTANT(DISTANCE_SHADING_CONSTANT_ID) bool distance_shading = true;
+SPECIALIZATION_CONSTANT(DISTANCE_SCALE_CONSTANT_ID) float distance_scale = 100.0;
+
 void main()
 {
-    vec4 zero = vec4(0.0, 0.0, 0.0, 1.0);
-    color = (distance(fPos, zero) / 100.0) * fColor;
+    color = fColor;
+    if (distance_shading) {
+        vec4 zero = vec4(0.0, 0.0, 0.0, 1.0);
+        color *= distance(fPos, zero) / distance_scale;
+    }
 }
\ No newline at end of file
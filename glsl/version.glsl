@@ -1 +1,16 @@
-#version 460 core
\ No newline at end of file
+#version 460 core
+// VULKAN is defined by glslang when targeting Vulkan, OpenGL compiles the GLSL as is
+#ifdef VULKAN
+#extension GL_EXT_nonuniform_qualifier : require
+#define SPECIALIZATION_CONSTANT(id) layout(constant_id = id) const
+#define DRAW_CONSTANTS(block) layout(push_constant) uniform block { mat4 mvp; uint draw_index; } draw_constants;
+#define DRAW_DATA(block) layout(std430, binding = DRAW_DATA_BINDING) readonly buffer block { ObjectData object; } objects[];
+#define DRAW_MVP draw_constants.mvp
+#define OBJECT_COLOR objects[nonuniformEXT(draw_constants.draw_index)].object.color
+#else
+#define SPECIALIZATION_CONSTANT(id) const
+#define DRAW_CONSTANTS(block)
+#define DRAW_DATA(block) layout(std430, binding = DRAW_DATA_BINDING) readonly buffer block { DrawData draws[]; };
+#define DRAW_MVP draws[gl_BaseInstance + gl_DrawID].mvp
+#define OBJECT_COLOR vec4(1.0)
+#endif
\ No newline at end of file
@@ -13,9 +13,26 @@ layout(binding = UNIFORM_BLOCK_BINDING) uniform UNIFORM_BUFFER_OBJECT
     mat4 proj;
 };
 
+struct DrawData
+{
+    mat4 mvp;
+};
+
+struct ObjectData
+{
+    vec4 color;
+};
+
+// the MVP is multiplied on the CPU, Vulkan pushes it with every draw; a multi-draw can't change uniforms
+// between its draws, so OpenGL reads it from draws[gl_BaseInstance + gl_DrawID]
+// Vulkan also pushes the draw's index into the bindless objects[] array, OpenGL has no per-object buffers
+DRAW_CONSTANTS(DRAW_CONSTANTS_BLOCK)
+DRAW_DATA(DRAW_DATA_BLOCK)
+
 void main()
 {
-    out_color = vColor;
-    out_pos = proj * view * model * vec4(vPosition, 1.0);
-    gl_Position = out_pos;
+    out_color = vColor * OBJECT_COLOR;
+    // the camera comes from the per-frame uniform block, distance shading works in view space
+    out_pos = view * model * vec4(vPosition, 1.0);
+    gl_Position = DRAW_MVP * vec4(vPosition, 1.0);
 }
\ No newline at end of file
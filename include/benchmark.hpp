@@ -0,0 +1,77 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+// frame time statistics of Renderer::run, configured by the bench_* parameters
+class Benchmark
+{
+public:
+    static constexpr size_t HistogramBuckets = 20;
+
+    struct SeriesStats
+    {
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+    };
+
+    struct Stats
+    {
+        size_t frames = 0;
+        double mean = 0.0; // everything in microseconds
+        double stddev = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p99 = 0.0;
+        double p999 = 0.0;
+        std::vector<size_t> histogram; // HistogramBuckets equal buckets over [min, max]
+        std::map<std::string, SeriesStats> series;
+    };
+
+public:
+    DLL_EXPORT Benchmark();
+
+    DLL_EXPORT bool warmingUp() const { return frame_ < warmup_frames_; }
+    DLL_EXPORT bool done(std::chrono::steady_clock::time_point now) const;
+    DLL_EXPORT void addFrame(std::chrono::nanoseconds frame_time, std::chrono::steady_clock::time_point now);
+    // any other per-frame measurement, such as GPU times, dropped while warming up;
+    // series named *_us are compared to the baseline like the frame times
+    DLL_EXPORT void addSample(std::string_view series, double value);
+
+    // build and config description written next to the results
+    DLL_EXPORT void setMetadata(std::string_view key, std::string value);
+
+    DLL_EXPORT Stats stats() const;
+    DLL_EXPORT void print(std::ostream& out, const Stats& stats) const;
+    DLL_EXPORT bool write(const Stats& stats) const;
+    // false if any statistic is worse than in the baseline file by more than bench_threshold percent
+    DLL_EXPORT bool compareToBaseline(std::ostream& out, const Stats& stats) const;
+
+private:
+    void writeJson(std::ostream& out, const Stats& stats) const;
+    void writeCsv(std::ostream& out, const Stats& stats) const;
+
+private:
+    size_t warmup_frames_ = 0;
+    size_t measured_frames_ = 0;
+    std::chrono::nanoseconds duration_{}; // takes precedence over measured_frames_ when set
+    std::chrono::steady_clock::time_point measure_start_{};
+    std::string output_;
+    std::string baseline_;
+    double threshold_ = 0.0;
+
+    size_t frame_ = 0;
+    std::vector<uint64_t> frame_times_; // nanoseconds
+    std::map<std::string, std::vector<double>, std::less<>> samples_;
+    std::map<std::string, std::string> metadata_;
+};
+
+#endif // BENCHMARK_HPP
@@ -12,4 +12,24 @@
 
 #ifndef UNIFORM_BLOCK_BINDING
 #define UNIFORM_BLOCK_BINDING 0
-#endif
\ No newline at end of file
+#endif
+
+#ifndef DRAW_DATA_BLOCK
+#define DRAW_DATA_BLOCK DrawDataBlock
+#endif
+
+#ifndef DRAW_DATA_BINDING
+#define DRAW_DATA_BINDING 1
+#endif
+
+#ifndef DRAW_CONSTANTS_BLOCK
+#define DRAW_CONSTANTS_BLOCK DrawConstantsBlock
+#endif
+
+#ifndef DISTANCE_SHADING_CONSTANT_ID
+#define DISTANCE_SHADING_CONSTANT_ID 0
+#endif
+
+#ifndef DISTANCE_SCALE_CONSTANT_ID
+#define DISTANCE_SCALE_CONSTANT_ID 1
+#endif
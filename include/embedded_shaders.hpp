@@ -0,0 +1,27 @@
+#ifndef EMBEDDED_SHADERS_HPP
+#define EMBEDDED_SHADERS_HPP
+
+#include <cstdint>
+
+// SPIR-V generated by the pre-build event of the shaders project, EMBEDDED_SHADERS is defined by projects that build after it
+#ifdef EMBEDDED_SHADERS
+
+#if !__has_include("shaders/vertex.vert.spv.inc") || !__has_include("shaders/fragment.frag.spv.inc")
+#error "EMBEDDED_SHADERS is defined but include/shaders/*.spv.inc are missing, build the shaders project first"
+#endif
+
+namespace shaders {
+
+inline constexpr uint32_t vertex[] = {
+#include "shaders/vertex.vert.spv.inc"
+};
+
+inline constexpr uint32_t fragment[] = {
+#include "shaders/fragment.frag.spv.inc"
+};
+
+} // namespace shaders
+
+#endif // EMBEDDED_SHADERS
+
+#endif // EMBEDDED_SHADERS_HPP
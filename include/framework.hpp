@@ -1,11 +1,14 @@
 #ifndef FRAMEWORK_HPP
 #define FRAMEWORK_HPP
 
+#include <bit>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "config.hpp"
+#include "memory_stats.hpp"
 #include "util.hpp"
 
 struct GLFWwindow;
@@ -20,6 +23,39 @@ namespace impl {
 
 class CommandQueue;
 
+struct GpuPassTime
+{
+    std::string_view name;
+    double           time_us = 0.0;
+};
+
+// what the GPU did for one frame, the pipeline statistics stay zero where the backend cannot query them
+struct GpuFrameStats
+{
+    std::vector<GpuPassTime> passes;
+    uint64_t input_primitives           = 0;
+    uint64_t vertex_invocations         = 0;
+    uint64_t fragment_invocations       = 0;
+    uint64_t clipping_input_primitives  = 0;
+    uint64_t clipping_output_primitives = 0; // fewer than the input ones when primitives were clipped away
+};
+
+// queries are ring-buffered across frames and read back once they are available, so results lag
+// a few frames behind and a frame whose queries were not done yet is skipped instead of waited for
+class GpuProfiler
+{
+public:
+    virtual ~GpuProfiler() = default;
+
+    const Opt<GpuFrameStats>& latest() const { return latest_; }
+    // grows by one with every frame read back, latest() changed when this did
+    uint64_t completedFrames() const { return completed_frames_; }
+
+protected:
+    Opt<GpuFrameStats> latest_;
+    uint64_t           completed_frames_ = 0;
+};
+
 class Window
 {
 public:
@@ -33,12 +69,19 @@ public:
         return { width_, height_ };
     }
 
+    // frames are rendered offscreen, there is no GLFW window to show them or to poll
+    DLL_EXPORT bool headless() const { return headless_; }
+
     DLL_EXPORT bool shouldClose();
     DLL_EXPORT void pollEvents();
     virtual void swapFramebuffers(CommandQueue&) = 0;
+    // null for backends without a GPU or when gpu_profiler is off in the config
+    virtual const GpuProfiler* gpuProfiler() const { return nullptr; }
+    // what the driver reports next to MemoryStats, only Vulkan with VK_EXT_memory_budget can tell
+    virtual void printMemoryBudget(std::ostream& out) const {}
 
 protected:
-    DLL_EXPORT Window(uint32_t width, uint32_t height, std::string_view title, const HintsList hints = {}) noexcept;
+    DLL_EXPORT Window(uint32_t width, uint32_t height, std::string_view title, const HintsList hints = {}, bool headless = false) noexcept;
 
     static void errorCallback(int error, const char* descr);
     static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
@@ -47,6 +90,7 @@ protected:
 protected:
     std::shared_ptr<GLFWwindow> window_;
     uint32_t width_, height_;
+    bool headless_ = false;
 };
 
 class Application
@@ -109,10 +153,86 @@ protected:
         if (items.size() > 0) {
             storage_.assign(items.begin(), items.end());
         }
+        storage_memory_.resize(storage_.size() * sizeof(T));
     }
 
 protected:
     Container storage_;
+
+private:
+    MemoryStats::Allocation storage_memory_{ MemoryStats::Heap::Host, MemoryStats::Category::ShadowCopies, 0 };
+};
+
+struct GeometryRange
+{
+    uint32_t first_index   = 0;
+    uint32_t index_count   = 0;
+    int32_t  vertex_offset = 0;
+};
+
+class GeometryPoolHandle
+{
+public:
+    virtual ~GeometryPoolHandle() = default;
+
+    uint16_t id() const { return id_; }
+
+protected:
+    static size_t grownCapacity(size_t capacity, size_t required)
+    {
+        constexpr size_t MinCapacity = 64 * 1024;
+        return std::max({ required, capacity * 2, MinCapacity });
+    }
+
+private:
+    inline static uint16_t next_id_ = 0;
+    const uint16_t id_ = next_id_++;
+};
+
+template<std::default_initializable V>
+class GeometryPool
+{
+protected:
+    using VertexContainer = std::vector<V>;
+    using IndexContainer  = std::vector<uint32_t>;
+
+public:
+    virtual ~GeometryPool() = default;
+
+    Opt<GeometryRange> add(const VertexContainer& vertices, const IndexContainer& indices)
+    {
+        const auto first_vertex = vertices_.size();
+        const auto first_index = indices_.size();
+        vertices_.insert(vertices_.end(), vertices.begin(), vertices.end());
+        indices_.insert(indices_.end(), indices.begin(), indices.end());
+        shadow_memory_.resize(vertices_.capacity() * sizeof(V) + indices_.capacity() * sizeof(uint32_t));
+        if (!upload(first_vertex, first_index)) {
+            vertices_.resize(first_vertex);
+            indices_.resize(first_index);
+            return util::handle_error();
+        }
+        return GeometryRange{
+              static_cast<uint32_t>(first_index)
+            , static_cast<uint32_t>(indices.size())
+            , static_cast<int32_t>(first_vertex)
+        };
+    }
+
+    const VertexContainer& vertices() const { return vertices_; }
+    const IndexContainer& indices() const { return indices_; }
+
+protected:
+    GeometryPool() = default;
+
+    // uploads everything past first_vertex/first_index, growing device storage when it does not fit
+    virtual bool upload(size_t first_vertex, size_t first_index) = 0;
+
+protected:
+    VertexContainer vertices_;
+    IndexContainer  indices_;
+
+private:
+    MemoryStats::Allocation shadow_memory_{ MemoryStats::Heap::Host, MemoryStats::Category::ShadowCopies, 0 };
 };
 
 class GlslShader
@@ -121,13 +241,67 @@ public:
     virtual ~GlslShader() = default;
 };
 
+// values for the specialization constants of one shader stage, by constant_id; constants that are not set
+// keep the default from the shader source, which is all the OpenGL backend supports
+class SpecializationConstants
+{
+public:
+    SpecializationConstants& set(uint32_t id, bool value)
+    {
+        return setBits(id, value ? 1u : 0u); // VkBool32
+    }
+
+    template<typename T>
+        requires (std::is_arithmetic_v<T> && sizeof(T) == sizeof(uint32_t))
+    SpecializationConstants& set(uint32_t id, T value)
+    {
+        return setBits(id, std::bit_cast<uint32_t>(value));
+    }
+
+    const std::vector<std::pair<uint32_t, uint32_t>>& values() const { return values_; }
+
+private:
+    SpecializationConstants& setBits(uint32_t id, uint32_t bits)
+    {
+        const auto it = std::ranges::find(values_, id, &std::pair<uint32_t, uint32_t>::first);
+        if (it != values_.end()) {
+            it->second = bits;
+        }
+        else {
+            values_.emplace_back(id, bits);
+        }
+        return *this;
+    }
+
+private:
+    std::vector<std::pair<uint32_t, uint32_t>> values_;
+};
+
 class Pipeline
 {
 public:
     virtual ~Pipeline() = default;
 
-    virtual void addShader(const GlslShader& shader) = 0;
+    uint16_t id() const { return id_; }
+
+    virtual void addShader(const GlslShader& shader, const SpecializationConstants& constants = {}) = 0;
     virtual bool use(const VertexDescription& description) = 0;
+
+private:
+    inline static uint16_t next_id_ = 0;
+    const uint16_t id_ = next_id_++;
+};
+
+// dispatches go into the command queue before the clear command, the Vulkan and OpenGL backends refuse them after it
+class ComputePipeline
+{
+public:
+    virtual ~ComputePipeline() = default;
+
+    virtual void setShader(const GlslShader& shader, const SpecializationConstants& constants = {}) = 0;
+    // binds buffer to the storage block declared with this binding in the compute shader
+    virtual void addStorageBuffer(uint32_t binding, const BufferHandle& buffer) = 0;
+    virtual bool use() = 0;
 };
 
 template<typename UBO>
@@ -136,23 +310,126 @@ class UniformBlock
 public:
     virtual ~UniformBlock() = default;
 
+    // uploads only what changed since the previous update
     virtual void update() = 0;
     virtual UBO& get() = 0;
+
+    // bytes written to the device by the last update, summed over all copies
+    size_t uploadedBytes() const { return uploaded_bytes_; }
+
+protected:
+    size_t uploaded_bytes_ = 0;
 };
 
 struct Command;
 
+struct BindStats
+{
+    uint64_t issued = 0;
+    uint64_t elided = 0;
+};
+
+// what one frame submitted, counted while it is recorded; stays zero where a backend has no such thing
+struct FrameStats
+{
+    uint64_t draw_calls       = 0; // draw commands, OpenGL gathers them into fewer multi-draws
+    uint64_t triangles        = 0;
+    uint64_t indices          = 0;
+    uint64_t pipeline_binds   = 0;
+    uint64_t descriptor_binds = 0;
+    uint64_t buffer_binds     = 0;
+    uint64_t mapped_bytes     = 0; // written to mapped device memory
+    uint64_t uniform_bytes    = 0; // changed uniform ranges uploaded, counted apart from mapped_bytes
+    uint64_t command_buffers  = 0;
+    uint64_t allocations      = 0; // device buffers created
+    double   fence_wait_us    = 0.0;
+};
+
 class CommandQueue
 {
 public:
     virtual ~CommandQueue() = default;
 
     virtual void addCommand(Command& command) = 0;
+
+    const BindStats& getBindStats() const { return bind_stats_; }
+    // counters of the frame submitted last, the next frame counts from zero
+    FrameStats takeFrameStats() { return std::exchange(frame_stats_, {}); }
+
+protected:
+    DLL_EXPORT void sortCommands(std::vector<Command*>& commands);
+
+    template<typename State>
+    bool changeState(State& bound, State value, uint64_t FrameStats::* binds)
+    {
+        if (bound == value) {
+            ++bind_stats_.elided;
+            return false;
+        }
+        bound = value;
+        ++bind_stats_.issued;
+        ++(frame_stats_.*binds);
+        return true;
+    }
+
+    void countDraw(uint32_t index_count)
+    {
+        ++frame_stats_.draw_calls;
+        frame_stats_.indices += index_count;
+        frame_stats_.triangles += index_count / 3;
+    }
+
+protected:
+    BindStats  bind_stats_;
+    FrameStats frame_stats_;
+
+private:
+    std::vector<std::pair<uint64_t, Command*>> sort_keys_;
+    std::vector<std::pair<uint64_t, Command*>> sort_scratch_;
 };
 
 struct Command
 {
     virtual void operator()(CommandQueue& queue) = 0;
+
+    // commands without a key keep their position, keyed commands between them are reordered
+    virtual Opt<uint64_t> sortKey() const { return std::nullopt; }
+};
+
+// | pipeline : 16 | descriptor set : 16 | geometry : 16 | depth bucket : 16 |
+constexpr uint64_t makeSortKey(uint16_t pipeline, uint16_t descriptor_set, uint16_t geometry, uint16_t depth_bucket)
+{
+    return (static_cast<uint64_t>(pipeline) << 48)
+         | (static_cast<uint64_t>(descriptor_set) << 32)
+         | (static_cast<uint64_t>(geometry) << 16)
+         | static_cast<uint64_t>(depth_bucket);
+}
+
+class DrawCommand : public Command
+{
+public:
+    Opt<uint64_t> sortKey() const override
+    {
+        return makeSortKey(pipeline_id_, descriptor_set_, geometry_id_, depth_bucket_);
+    }
+
+    // normalized view depth, draws closer to the camera are recorded first
+    void setDepth(float depth)
+    {
+        depth_bucket_ = static_cast<uint16_t>(std::clamp(depth, 0.0f, 1.0f) * std::numeric_limits<uint16_t>::max());
+    }
+
+protected:
+    DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry) noexcept
+        : pipeline_id_{ pipeline.id() }
+        , geometry_id_{ geometry.id() }
+    {}
+
+protected:
+    const uint16_t pipeline_id_;
+    uint16_t       descriptor_set_ = 0;
+    const uint16_t geometry_id_;
+    uint16_t       depth_bucket_ = 0;
 };
 
 } // namespace impl
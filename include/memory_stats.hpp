@@ -0,0 +1,86 @@
+#ifndef MEMORY_STATS_HPP
+#define MEMORY_STATS_HPP
+
+#include <array>
+#include <mutex>
+#include <ostream>
+
+#include "util.hpp"
+
+// bytes held by the framework, by heap and category, with the highest each has reached
+class MemoryStats
+{
+public:
+    enum class Heap
+    {
+          Host
+        , Device
+        , Count
+    };
+
+    enum class Category
+    {
+          Geometry
+        , Uniforms    // uniform blocks and other data shaders read
+        , Staging     // rewritten by the CPU every frame
+        , Images
+        , ShaderCode
+        , ShadowCopies // CPU copies of what was uploaded
+        , Count
+    };
+
+    struct Usage
+    {
+        size_t current = 0;
+        size_t peak = 0;
+    };
+
+    // the bytes of one allocation, counted for as long as it lives
+    class Allocation
+    {
+    public:
+        Allocation() noexcept = default;
+        DLL_EXPORT Allocation(Heap heap, Category category, size_t bytes) noexcept;
+        DLL_EXPORT Allocation(Allocation&& rhs) noexcept;
+        DLL_EXPORT Allocation& operator=(Allocation&& rhs) noexcept;
+        DLL_EXPORT ~Allocation();
+
+        Allocation(const Allocation&) = delete;
+        Allocation& operator=(const Allocation&) = delete;
+
+        // for storage that grows or shrinks in place
+        DLL_EXPORT void resize(size_t bytes);
+        size_t bytes() const { return bytes_; }
+
+    private:
+        Heap     heap_ = Heap::Host;
+        Category category_ = Category::Geometry;
+        size_t   bytes_ = 0;
+    };
+
+public:
+    DLL_EXPORT static MemoryStats& instance();
+
+    DLL_EXPORT Usage usage(Heap heap, Category category) const;
+    // the peak is that of the sum, not the sum of the category peaks
+    DLL_EXPORT Usage total(Heap heap) const;
+
+    DLL_EXPORT void print(std::ostream& out, std::string_view when) const;
+
+private:
+    MemoryStats() = default;
+
+    void add(Heap heap, Category category, size_t bytes);
+    void remove(Heap heap, Category category, size_t bytes);
+
+private:
+    static constexpr size_t HeapCount = static_cast<size_t>(Heap::Count);
+    static constexpr size_t CategoryCount = static_cast<size_t>(Category::Count);
+
+    // allocations come from the pool threads too, shaders are created there
+    mutable std::mutex mutex_;
+    std::array<std::array<Usage, CategoryCount>, HeapCount> usage_{};
+    std::array<Usage, HeapCount> totals_{};
+};
+
+#endif // MEMORY_STATS_HPP
@@ -11,6 +11,97 @@
 
 namespace impl {
 
+// the matrices are rebuilt on first use after one of their inputs changed
+class Camera
+{
+public:
+    // Vulkan clip space has y pointing down
+    explicit Camera(bool flip_y) noexcept
+        : flip_y_{ flip_y }
+    {}
+
+    void lookAt(const glm::vec3& eye, const glm::vec3& center, const glm::vec3& up)
+    {
+        if (eye == eye_ && center == center_ && up == up_) {
+            return;
+        }
+        eye_ = eye;
+        center_ = center;
+        up_ = up;
+        view_dirty_ = true;
+    }
+
+    void perspective(float fov, float aspect, float near_plane, float far_plane)
+    {
+        if (fov == fov_ && aspect == aspect_ && near_plane == near_ && far_plane == far_) {
+            return;
+        }
+        fov_ = fov;
+        aspect_ = aspect;
+        near_ = near_plane;
+        far_ = far_plane;
+        proj_dirty_ = true;
+    }
+
+    const glm::mat4& view()
+    {
+        if (view_dirty_) {
+            view_ = glm::lookAt(eye_, center_, up_);
+            view_dirty_ = false;
+            view_proj_dirty_ = true;
+        }
+        return view_;
+    }
+
+    const glm::mat4& proj()
+    {
+        if (proj_dirty_) {
+            proj_ = glm::perspective(fov_, aspect_, near_, far_);
+            if (flip_y_) {
+                proj_[1][1] *= -1;
+            }
+            proj_dirty_ = false;
+            view_proj_dirty_ = true;
+        }
+        return proj_;
+    }
+
+    const glm::mat4& viewProj()
+    {
+        const auto& v = view();
+        const auto& p = proj();
+        if (view_proj_dirty_) {
+            view_proj_ = p * v;
+            view_proj_dirty_ = false;
+        }
+        return view_proj_;
+    }
+
+private:
+    const bool flip_y_;
+    glm::vec3  eye_{}, center_{}, up_{};
+    float      fov_ = 0.0f, aspect_ = 0.0f, near_ = 0.0f, far_ = 0.0f;
+    glm::mat4  view_{ 1.0f }, proj_{ 1.0f }, view_proj_{ 1.0f };
+    bool       view_dirty_ = true, proj_dirty_ = true, view_proj_dirty_ = true;
+};
+
+// accumulated model transform, rotations of zero leave it untouched
+class Transform
+{
+public:
+    void rotate(float angle, const glm::vec3& axis)
+    {
+        if (angle != 0.0f) {
+            matrix_ = glm::rotate(matrix_, angle, axis);
+        }
+    }
+
+    const glm::mat4& matrix() const { return matrix_; }
+
+private:
+    glm::mat4 matrix_{ 1.0f };
+};
+
 class Renderer
 {
 protected:
@@ -20,14 +111,16 @@ protected:
 public:
     virtual void run() = 0;
 
+    // counters of the frame run() rendered last
+    const FrameStats& frameStats() const { return frame_stats_; }
+
 protected:
     Renderer() noexcept = default;
 
 protected:
     Ptr<impl::Application>       application_;
     Ptr<impl::DebugInfo>         debug_info_;
-    Ptr<impl::BufferHandle>      vertex_buffer_;
-    Ptr<impl::BufferHandle>      index_buffer_;
+    Ptr<impl::GeometryPoolHandle> geometry_;
     Ptr<impl::GlslShader>        vertex_shader_;
     Ptr<impl::GlslShader>        fragment_shader_;
     Ptr<impl::Pipeline>          pipeline_;
@@ -36,8 +129,11 @@ protected:
     Ptr<impl::VertexAttribute>   color_;
     Ptr<impl::VertexDescription> vertex_description_;
     Ptr<impl::Command>           clear_command_;
-    Ptr<impl::Command>           draw_command_;
+    std::vector<Ptr<impl::Command>> draw_commands_;
+    std::vector<glm::vec3>       draw_centers_; // model space centroid of each draw's geometry, for the depth sort
+    std::vector<Ptr<impl::BufferHandle>> object_buffers_; // one ObjectData per draw, Vulkan only
     Ptr<impl::CommandQueue>      command_queue_;
+    FrameStats                   frame_stats_;
 };
 
 } // namespace impl
@@ -1,9 +1,15 @@
+#include <array>
 #include <numeric>
 #include <chrono>
 #include <thread>
 
+#include "benchmark.hpp"
 #include "constants.h"
+#include "embedded_shaders.hpp"
 #include "model.hpp"
+#include "startup_profile.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 #ifdef OPENGL
 
@@ -12,6 +18,7 @@
 #include "opengl/buffer.hpp"
 #include "opengl/command_queue.hpp"
 #include "opengl/debug_info.hpp"
+#include "opengl/geometry_pool.hpp"
 #include "opengl/glsl_shader.hpp"
 #include "opengl/pipeline.hpp"
 #include "opengl/uniform_block.hpp"
@@ -27,6 +34,7 @@
 #include "vulkan/buffer.hpp"
 #include "vulkan/command_queue.hpp"
 #include "vulkan/debug_info.hpp"
+#include "vulkan/geometry_pool.hpp"
 #include "vulkan/glsl_shader.hpp"
 #include "vulkan/pipeline.hpp"
 #include "vulkan/uniform_block.hpp"
@@ -36,6 +44,38 @@
 
 #endif // VULKAN
 
+#ifdef CPU
+
+#include "cpu/application.hpp"
+#include "cpu/buffer.hpp"
+#include "cpu/command_queue.hpp"
+#include "cpu/debug_info.hpp"
+#include "cpu/geometry_pool.hpp"
+#include "cpu/glsl_shader.hpp"
+#include "cpu/pipeline.hpp"
+#include "cpu/uniform_block.hpp"
+#include "cpu/vertex_attribute.hpp"
+#include "cpu/vertex_description.hpp"
+#include "cpu/window.hpp"
+
+#endif // CPU
+
+#ifdef NULL_BACKEND
+
+#include "null/application.hpp"
+#include "null/buffer.hpp"
+#include "null/command_queue.hpp"
+#include "null/debug_info.hpp"
+#include "null/geometry_pool.hpp"
+#include "null/glsl_shader.hpp"
+#include "null/pipeline.hpp"
+#include "null/uniform_block.hpp"
+#include "null/vertex_attribute.hpp"
+#include "null/vertex_description.hpp"
+#include "null/window.hpp"
+
+#endif // NULL_BACKEND
+
 #define OPT_DECLARE_ASSIGN_OR_RETURN(var, expr) \
     typename decltype(expr)::value_type var{};  \
     if (const auto _result = (expr); _result)   \
@@ -54,62 +94,174 @@
 #ifdef VULKAN
     #define ns vulkan
 #endif
+#ifdef CPU
+    #define ns cpu
+#endif
+#ifdef NULL_BACKEND
+    #define ns null
+#endif
 
 namespace ns {
 
 Ptr<impl::Window> g_window;
 
+namespace {
+
+constexpr std::array<std::pair<std::string_view, uint64_t impl::FrameStats::*>, 10> FrameCounters{ {
+      { "draw_calls"      , &impl::FrameStats::draw_calls       }
+    , { "triangles"       , &impl::FrameStats::triangles        }
+    , { "indices"         , &impl::FrameStats::indices          }
+    , { "pipeline_binds"  , &impl::FrameStats::pipeline_binds   }
+    , { "descriptor_binds", &impl::FrameStats::descriptor_binds }
+    , { "buffer_binds"    , &impl::FrameStats::buffer_binds     }
+    , { "mapped_bytes"    , &impl::FrameStats::mapped_bytes     }
+    , { "uniform_bytes"   , &impl::FrameStats::uniform_bytes    }
+    , { "command_buffers" , &impl::FrameStats::command_buffers  }
+    , { "allocations"     , &impl::FrameStats::allocations      }
+} };
+
+} // namespace
+
 DLL_EXPORT Ptr<impl::Renderer> Renderer::create() noexcept
 {
     OPT_DECLARE_ASSIGN_OR_RETURN(width               , Config::instance().get<uint32_t>("width"));
     OPT_DECLARE_ASSIGN_OR_RETURN(height              , Config::instance().get<uint32_t>("height"));
     OPT_DECLARE_ASSIGN_OR_RETURN(title               , Config::instance().get<std::string>("title"));
-    OPT_DECLARE_ASSIGN_OR_RETURN(model_file          , Config::instance().get<std::string>("model"));
+    OPT_DECLARE_ASSIGN_OR_RETURN(model_files         , (Config::instance().get<std::vector, std::string>("model")));
     OPT_DECLARE_ASSIGN_OR_RETURN(vertex_shader_file  , Config::instance().get<std::string>("vertex_shader"));
     OPT_DECLARE_ASSIGN_OR_RETURN(fragment_shader_file, Config::instance().get<std::string>("fragment_shader"));
 
-    const auto start = std::chrono::high_resolution_clock::now();
+    auto& profile = StartupProfile::instance();
+    const auto create_stage = profile.stage("Renderer::create");
 
     Ptr<Renderer> renderer{ new Renderer{} };
-    PTR_ASSIGN_OR_RETURN(g_window, Window::create(width, height, title));
-
-    PTR_ASSIGN_OR_RETURN(renderer->application_, Application::create());
-    PTR_ASSIGN_OR_RETURN(renderer->debug_info_ , DebugInfo::create(*renderer->application_));
-
-    const auto [vertex_buffer_data, index_buffer_data] = off::fromFile(model_file);
+    {
+        const auto stage = profile.stage("window");
+        PTR_ASSIGN_OR_RETURN(g_window, Window::create(width, height, title));
+    }
+    {
+        const auto stage = profile.stage("application");
+        PTR_ASSIGN_OR_RETURN(renderer->application_, Application::create());
+        PTR_ASSIGN_OR_RETURN(renderer->debug_info_ , DebugInfo::create(*renderer->application_));
+    }
 
-    PTR_ASSIGN_OR_RETURN(renderer->vertex_buffer_, Buffer<Vertex>::create(BufferUsage::Vertex, vertex_buffer_data));
-    PTR_ASSIGN_OR_RETURN(renderer->index_buffer_, Buffer<uint32_t>::create(BufferUsage::Index, index_buffer_data));
+    auto geometry = GeometryPool<Vertex>::create();
+    if (!geometry) {
+        return util::handle_error();
+    }
+    std::vector<impl::GeometryRange> geometry_ranges{};
+    geometry_ranges.reserve(model_files.size());
+    for (const auto& model_file : model_files) {
+        const auto stage = profile.stage("model " + model_file);
+        const auto [vertices, indices] = off::fromFile(model_file);
+        // parsed models only live until they are in the geometry pool, this shows in the peak
+        const MemoryStats::Allocation model_memory{ MemoryStats::Heap::Host, MemoryStats::Category::Geometry, vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t) };
+        const auto upload_stage = profile.stage("upload");
+        OPT_DECLARE_ASSIGN_OR_RETURN(range, geometry->add(vertices, indices));
+        geometry_ranges.push_back(range);
+        glm::vec3 center{ 0.0f };
+        for (const auto& vertex : vertices) {
+            center += vertex.pos;
+        }
+        renderer->draw_centers_.push_back(vertices.empty() ? center : center / static_cast<float>(vertices.size()));
+    }
+    renderer->geometry_ = std::move(geometry);
+
+    {
+        const auto stage = profile.stage("shaders");
+        // every stage is prepared on its own thread, GL only reads the sources here and compiles in Pipeline::use
+        util::thread_pool pool{};
+#if defined(VULKAN) && defined(EMBEDDED_SHADERS)
+        // compiled from glsl/ at build time, the shader files named in the config are not read
+        auto vertex_shader = pool.submit([&]() {
+            const auto shader_stage = profile.stage("vertex", stage);
+            return GlslShader::create(ShaderType::Vertex, shaders::vertex);
+        });
+        auto fragment_shader = pool.submit([&]() {
+            const auto shader_stage = profile.stage("fragment", stage);
+            return GlslShader::create(ShaderType::Fragment, shaders::fragment);
+        });
+#else
+        auto vertex_shader = pool.submit([&]() {
+            const auto shader_stage = profile.stage("vertex " + vertex_shader_file, stage);
+            return GlslShader::create(ShaderType::Vertex, vertex_shader_file);
+        });
+        auto fragment_shader = pool.submit([&]() {
+            const auto shader_stage = profile.stage("fragment " + fragment_shader_file, stage);
+            return GlslShader::create(ShaderType::Fragment, fragment_shader_file);
+        });
+#endif
+        PTR_ASSIGN_OR_RETURN(renderer->vertex_shader_, vertex_shader.get());
+        PTR_ASSIGN_OR_RETURN(renderer->fragment_shader_, fragment_shader.get());
+    }
 
-    const auto start_shader = std::chrono::high_resolution_clock::now();
-    PTR_ASSIGN_OR_RETURN(renderer->vertex_shader_, GlslShader::create(ShaderType::Vertex, vertex_shader_file));
-    PTR_ASSIGN_OR_RETURN(renderer->fragment_shader_, GlslShader::create(ShaderType::Fragment, fragment_shader_file));
+    {
+        const auto stage = profile.stage("pipeline");
+        PTR_ASSIGN_OR_RETURN(renderer->ubo_, UniformBlock<UNIFORM_BUFFER_OBJECT>::create(*renderer->vertex_shader_, STR(UNIFORM_BUFFER_OBJECT), UNIFORM_BLOCK_BINDING));
 
-    PTR_ASSIGN_OR_RETURN(renderer->ubo_, UniformBlock<UNIFORM_BUFFER_OBJECT>::create(*renderer->vertex_shader_, STR(UNIFORM_BUFFER_OBJECT), UNIFORM_BLOCK_BINDING));
+        // specialized when the pipeline is created, one fragment shader module serves every combination
+        impl::SpecializationConstants fragment_constants{};
+        if (const auto distance_shading = Config::instance().get<uint32_t>("distance_shading")) {
+            fragment_constants.set(DISTANCE_SHADING_CONSTANT_ID, *distance_shading != 0);
+        }
+        if (const auto distance_scale = Config::instance().get<float>("distance_scale")) {
+            fragment_constants.set(DISTANCE_SCALE_CONSTANT_ID, *distance_scale);
+        }
 
-    PTR_ASSIGN_OR_RETURN(renderer->pipeline_, Pipeline::create());
-    renderer->pipeline_->addShader(*renderer->vertex_shader_);
-    renderer->pipeline_->addShader(*renderer->fragment_shader_);
+        PTR_ASSIGN_OR_RETURN(renderer->pipeline_, Pipeline::create());
+        renderer->pipeline_->addShader(*renderer->vertex_shader_);
+        renderer->pipeline_->addShader(*renderer->fragment_shader_, fragment_constants);
 
-    PTR_ASSIGN_OR_RETURN(renderer->position_, VertexAttribute::create(VERTEX_POSITION_LOCATION, &Vertex::pos));
-    PTR_ASSIGN_OR_RETURN(renderer->color_, VertexAttribute::create(VERTEX_COLOR_LOCATION, &Vertex::color));
+        PTR_ASSIGN_OR_RETURN(renderer->position_, VertexAttribute::create(VERTEX_POSITION_LOCATION, &Vertex::pos));
+        PTR_ASSIGN_OR_RETURN(renderer->color_, VertexAttribute::create(VERTEX_COLOR_LOCATION, &Vertex::color));
 
-    PTR_ASSIGN_OR_RETURN(renderer->vertex_description_, VertexDescription::create());
-    renderer->vertex_description_->addAttribute(*renderer->position_);
-    renderer->vertex_description_->addAttribute(*renderer->color_);
-    renderer->pipeline_->use(*renderer->vertex_description_);
-    const auto end_shader = std::chrono::high_resolution_clock::now();
+        PTR_ASSIGN_OR_RETURN(renderer->vertex_description_, VertexDescription::create());
+        renderer->vertex_description_->addAttribute(*renderer->position_);
+        renderer->vertex_description_->addAttribute(*renderer->color_);
+    }
 
+    const auto commands_stage = profile.stage("commands");
+#ifdef VULKAN
+    // vkCreateGraphicsPipelines runs on the pool against the window's shared pipeline cache while the commands are
+    // created here, further pipelines are submitted alongside; GL links in Pipeline::use and its context is current
+    // on this thread only
+    util::thread_pool pool{};
+    auto pipeline_created = pool.submit([&]() {
+        const auto pipeline_stage = profile.stage("pipeline creation", commands_stage);
+        return renderer->pipeline_->use(*renderer->vertex_description_);
+    });
+#else
+    if (!renderer->pipeline_->use(*renderer->vertex_description_)) {
+        return util::handle_error();
+    }
+#endif // VULKAN
     PTR_ASSIGN_OR_RETURN(renderer->clear_command_, ClearCommand::create());
-    PTR_ASSIGN_OR_RETURN(renderer->draw_command_, DrawCommand::create(*renderer->vertex_buffer_, *renderer->index_buffer_));
+    for (const auto& range : geometry_ranges) {
+        auto& draw_command = renderer->draw_commands_.emplace_back();
+        PTR_ASSIGN_OR_RETURN(draw_command, DrawCommand::create(*renderer->pipeline_, *renderer->geometry_, range));
+    }
+#ifdef VULKAN
+    // the queue takes the render pass and the descriptor set layout from the created pipeline
+    if (!pipeline_created.get()) {
+        return util::handle_error();
+    }
+#endif // VULKAN
 
     PTR_ASSIGN_OR_RETURN(renderer->command_queue_, CommandQueue::create(*renderer->pipeline_));
     renderer->command_queue_->addCommand(*renderer->clear_command_);
-    renderer->command_queue_->addCommand(*renderer->draw_command_);
-
-    const auto end = std::chrono::high_resolution_clock::now();
-    std::cout << "Init time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start) << "\n";
-    std::cout << "Shader prepare time: " << std::chrono::duration_cast<std::chrono::microseconds>(end_shader - start_shader) << "\n";
+    for (const auto& draw_command : renderer->draw_commands_) {
+        renderer->command_queue_->addCommand(*draw_command);
+    }
+#ifdef VULKAN
+    // each draw reads its object's buffer out of the bindless array, the whole frame binds one descriptor set
+    auto& queue = dynamic_cast<CommandQueue&>(*renderer->command_queue_);
+    for (const auto& draw_command : renderer->draw_commands_) {
+        auto& object_buffer = renderer->object_buffers_.emplace_back();
+        PTR_ASSIGN_OR_RETURN(object_buffer, Buffer<ObjectData>::create(BufferUsage::Storage, { ObjectData{} }));
+        OPT_DECLARE_ASSIGN_OR_RETURN(draw_index, queue.addObjectBuffer(dynamic_cast<const BufferHandle&>(*object_buffer)));
+        dynamic_cast<DrawCommand&>(*draw_command).setDrawIndex(draw_index);
+    }
+#endif // VULKAN
 
     return renderer;
 }
@@ -126,53 +278,132 @@ DLL_EXPORT void Renderer::run()
 
     auto& uniform = dynamic_cast<UniformBlock<UNIFORM_BUFFER_OBJECT>&>(*ubo_);
 
-    std::vector<uint32_t> render_times{};
-    render_times.reserve(10000);
-
-    for (auto i = 0; i != 10000; ++i) {
-        static const std::chrono::milliseconds ms_per_frame{ static_cast<long>(1000.0 / fps) };
-        const auto start = std::chrono::high_resolution_clock::now();
-
-#ifdef VULKAN
-        const auto thread_count = Config::instance().get<uint32_t>("vk_framebuffers");
-        for (auto i = 0; i != thread_count; ++i) {
-#endif // VULKAN
-            uniform.get().view = glm::lookAt(
-                  glm::vec3(20.0, 20.0, 20.0) // camera pos
-                , glm::vec3(0.0, 0.0, 0.0)    // center
-                , YAxis                       // "up" axis
-            );
-            uniform.get().proj = glm::perspective(
-                  glm::radians(45.0)                  // fov
-                , width / static_cast<double>(height) // aspect ratio
-                , 1.0, 100.0                          // near and far plane
-            );
-            uniform.get().model = glm::rotate(uniform.get().model, glm::radians(1.0f), ZAxis);
 #ifdef VULKAN
-            uniform.get().proj[1][1] *= -1;
+    impl::Camera camera{ true };
+#else
+    impl::Camera camera{ false };
 #endif // VULKAN
-            uniform.update();
-#ifdef VULKAN
+    camera.lookAt(
+          glm::vec3(20.0, 20.0, 20.0) // camera pos
+        , glm::vec3(0.0, 0.0, 0.0)    // center
+        , YAxis                       // "up" axis
+    );
+    camera.perspective(
+          glm::radians(45.0f)                // fov
+        , width / static_cast<float>(height) // aspect ratio
+        , 1.0f, 100.0f                       // near and far plane
+    );
+    impl::Transform model{};
+
+    Benchmark benchmark{};
+    const auto* gpu_profiler = g_window->gpuProfiler();
+    uint64_t gpu_frames = 0;
+    size_t uniform_bytes = 0;
+    size_t draw_data_bytes = 0;
+    size_t frames = 0;
+    // fps=0 renders back to back
+    const std::chrono::nanoseconds frame_budget = fps ? std::chrono::nanoseconds{ 1'000'000'000 / fps } : std::chrono::nanoseconds{};
+
+    // the startup profile ends with the first frame, which also pays for lazily created state
+    auto first_frame_stage = std::optional{ StartupProfile::instance().stage("first frame") };
+
+    while (!benchmark.done(std::chrono::steady_clock::now())) {
+        const auto start = std::chrono::steady_clock::now();
+
+        model.rotate(glm::radians(1.0f), ZAxis);
+        // the camera doesn't move, so only the model range differs from what was uploaded
+        uniform.get().view = camera.view();
+        uniform.get().proj = camera.proj();
+        uniform.get().model = model.matrix();
+        uniform.update();
+
+        // one product per frame here instead of three per vertex
+        const glm::mat4 view_proj_model = camera.viewProj() * model.matrix();
+        for (size_t i = 0; i != draw_commands_.size(); ++i) {
+            auto& draw_command = dynamic_cast<DrawCommand&>(*draw_commands_[i]);
+            draw_command.drawData().mvp = view_proj_model;
+            // depth is zero to one in clip space, a centroid behind the camera sorts first
+            const glm::vec4 center = view_proj_model * glm::vec4(draw_centers_[i], 1.0f);
+            draw_command.setDepth(center.w > 0.0f ? center.z / center.w : 0.0f);
         }
-#endif // VULKAN
 
         g_window->swapFramebuffers(*command_queue_);
         g_window->pollEvents();
+        frame_stats_ = command_queue_->takeFrameStats();
+        frame_stats_.uniform_bytes = uniform.uploadedBytes();
+        uniform_bytes += frame_stats_.uniform_bytes;
+        draw_data_bytes += frame_stats_.mapped_bytes;
+
+        const auto end = std::chrono::steady_clock::now();
+        if (first_frame_stage) {
+            first_frame_stage.reset();
+            StartupProfile::instance().print(std::cout);
+            if (const auto path = Config::instance().get<std::string>("startup_profile")) {
+                IGNORE(StartupProfile::instance().write(*path));
+            }
+            MemoryStats::instance().print(std::cout, "startup");
+            g_window->printMemoryBudget(std::cout);
+        }
+        // nothing is printed per frame, the output itself skewed the timings
+        benchmark.addFrame(end - start, end);
+        // workload next to the frame times, so a change in one can be told from a change in the other
+        for (const auto& [name, counter] : FrameCounters) {
+            benchmark.addSample(name, static_cast<double>(frame_stats_.*counter));
+        }
+        benchmark.addSample("fence_wait_us", frame_stats_.fence_wait_us);
+        // GPU results arrive a few frames late and only once per frame, sampled when a new one is in
+        if (gpu_profiler && gpu_profiler->completedFrames() != gpu_frames && gpu_profiler->latest()) {
+            gpu_frames = gpu_profiler->completedFrames();
+            const auto& gpu = *gpu_profiler->latest();
+            for (const auto& [name, time_us] : gpu.passes) {
+                benchmark.addSample(std::string{ "gpu_" } + std::string{ name } + "_us", time_us);
+            }
+            benchmark.addSample("input_primitives", static_cast<double>(gpu.input_primitives));
+            benchmark.addSample("vertex_invocations", static_cast<double>(gpu.vertex_invocations));
+            benchmark.addSample("fragment_invocations", static_cast<double>(gpu.fragment_invocations));
+            // clipping can also split primitives in two, only the net loss is counted
+            const auto clipped = gpu.clipping_input_primitives - std::min(gpu.clipping_input_primitives, gpu.clipping_output_primitives);
+            benchmark.addSample("clipped_primitives", static_cast<double>(clipped));
+        }
+        ++frames;
+        if (frame_budget.count()) {
+            std::this_thread::sleep_for(frame_budget - (end - start));
+        }
+    }
 
-        const auto end = std::chrono::high_resolution_clock::now();
-        const auto render_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        const auto wait_time = ms_per_frame - render_time;
-        std::this_thread::sleep_for(wait_time);
-
-        std::cout << "Frame " << i + 1 << ": " << render_time << "us\n";
-        render_times.push_back(render_time.count());
+    benchmark.setMetadata("backend", Config::instance().get<std::string>("backend").value_or("vulkan"));
+    benchmark.setMetadata("model", Config::instance().get<std::string>("model").value_or(""));
+    benchmark.setMetadata("resolution", std::to_string(width) + "x" + std::to_string(height));
+    benchmark.setMetadata("headless", g_window->headless() ? "true" : "false");
+    benchmark.setMetadata("fps", std::to_string(fps));
+    benchmark.setMetadata("draws", std::to_string(draw_commands_.size()));
+#ifdef NDEBUG
+    benchmark.setMetadata("build", "release");
+#else
+    benchmark.setMetadata("build", "debug");
+#endif // NDEBUG
+#ifdef _MSC_VER
+    benchmark.setMetadata("compiler", "msvc " STR(_MSC_FULL_VER));
+#endif // _MSC_VER
+    benchmark.setMetadata("built", __DATE__ " " __TIME__);
+
+    const auto stats = benchmark.stats();
+    benchmark.print(std::cout, stats);
+    // with backend=null this is what the framework itself costs
+    std::cout << "Average per draw: " << stats.mean * 1000 / std::max<size_t>(draw_commands_.size(), 1) << "ns\n";
+    IGNORE(benchmark.write(stats));
+    if (!benchmark.compareToBaseline(std::cout, stats)) {
+        std::cout << "Frame times regressed against the baseline\n";
     }
-    std::cout << "Average: " << std::accumulate(render_times.begin(), render_times.end(), 0) / render_times.size() << "us\n";
-    const auto max = *std::ranges::max_element(render_times);
-    std::cout << "Max: " << max << "us\n";
-    const auto min = *std::ranges::min_element(render_times);
-    std::cout << "Min: " << min << "us\n";
-    std::cout << "Max difference: " << max - min << "us\n";
+    const auto& bind_stats = command_queue_->getBindStats();
+    std::cout << "Uniform upload average: " << uniform_bytes / std::max<size_t>(frames, 1) << " bytes per frame\n";
+    std::cout << "Per-draw data upload average: " << draw_data_bytes / std::max<size_t>(frames, 1) << " bytes per frame\n";
+    std::cout << "Binds issued: " << bind_stats.issued << ", elided: " << bind_stats.elided << "\n";
+    MemoryStats::instance().print(std::cout, "exit");
+    g_window->printMemoryBudget(std::cout);
+#ifdef TRACING
+    IGNORE(trace::dump());
+#endif // TRACING
 }
 
 } // namespace ns
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef STARTUP_PROFILE_HPP
+#define STARTUP_PROFILE_HPP
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+// tree of timed startup stages, a stage started while another one is running on the same thread becomes its child
+class StartupProfile
+{
+public:
+    class Stage
+    {
+        friend class StartupProfile;
+
+    public:
+        DLL_EXPORT Stage(Stage&& rhs) noexcept;
+        DLL_EXPORT ~Stage();
+
+        Stage(const Stage&) = delete;
+        Stage& operator=(const Stage&) = delete;
+        Stage& operator=(Stage&&) = delete;
+
+    private:
+        Stage(StartupProfile& profile, size_t node) noexcept;
+
+    private:
+        StartupProfile* profile_ = nullptr;
+        size_t node_ = 0;
+    };
+
+public:
+    DLL_EXPORT static StartupProfile& instance();
+
+    [[nodiscard]] DLL_EXPORT Stage stage(std::string_view name);
+    // for work handed to another thread, which does not see the stages of the submitting one
+    [[nodiscard]] DLL_EXPORT Stage stage(std::string_view name, const Stage& parent);
+
+    DLL_EXPORT void print(std::ostream& out) const;
+    // flame graph JSON, nested {"name", "value", "children"} with values in microseconds
+    DLL_EXPORT bool write(std::string_view path) const;
+
+private:
+    StartupProfile() = default;
+
+    Stage start(std::string_view name, size_t parent);
+    void finish(size_t node);
+    void printNode(std::ostream& out, size_t node, size_t depth) const;
+    void writeNode(std::ostream& out, size_t node, size_t depth) const;
+
+private:
+    static constexpr size_t NoParent = std::numeric_limits<size_t>::max();
+
+    struct Node
+    {
+        std::string name;
+        size_t parent = NoParent;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Node> nodes_;
+};
+
+#endif // STARTUP_PROFILE_HPP
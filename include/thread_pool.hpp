@@ -0,0 +1,82 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+class thread_pool
+{
+public:
+    explicit thread_pool(size_t thread_count = std::max(std::thread::hardware_concurrency(), 1u))
+    {
+        workers_.reserve(thread_count);
+        for (size_t i = 0; i != thread_count; ++i) {
+            workers_.emplace_back([this](std::stop_token stop) { work(stop); });
+        }
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard lock{ mutex_ };
+            for (auto& worker : workers_) {
+                worker.request_stop();
+            }
+        }
+        condition_.notify_all();
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    template<typename F>
+    [[nodiscard]] auto submit(F&& func) -> std::future<std::invoke_result_t<F>>
+    {
+        // packaged_task is move-only, std::function needs a copyable target
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(func));
+        auto future = task->get_future();
+        {
+            std::lock_guard lock{ mutex_ };
+            tasks_.emplace([task]() { (*task)(); });
+        }
+        condition_.notify_one();
+        return future;
+    }
+
+private:
+    // queued tasks are drained before a stopped worker returns, so no future is left without a value
+    void work(std::stop_token stop)
+    {
+        while (true) {
+            std::function<void()> task{};
+            {
+                std::unique_lock lock{ mutex_ };
+                condition_.wait(lock, [&]() { return stop.stop_requested() || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+private:
+    std::mutex                        mutex_;
+    std::condition_variable           condition_;
+    std::queue<std::function<void()>> tasks_;
+    std::vector<std::jthread>         workers_; // last, so workers are joined before the queue goes away
+};
+
+} // namespace util
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,54 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <string_view>
+
+#include "util.hpp"
+
+// CPU timeline of scoped zones, dumped as Chrome trace JSON (chrome://tracing, ui.perfetto.dev);
+// zones are only compiled in where TRACING is defined, otherwise TRACE_ZONE expands to nothing
+namespace trace {
+
+// nanoseconds since the first call
+DLL_EXPORT uint64_t now() noexcept;
+// name must outlive the dump, string literals only
+DLL_EXPORT void record(const char* name, uint64_t start, uint64_t end) noexcept;
+// everything recorded so far by every thread, can be called while other threads keep recording
+DLL_EXPORT bool dump(std::string_view path);
+// dumps to the trace_output path from the config, if there is one
+DLL_EXPORT bool dump();
+
+class Zone
+{
+public:
+    explicit Zone(const char* name) noexcept
+        : name_{ name }
+        , start_{ now() }
+    {}
+
+    ~Zone()
+    {
+        record(name_, start_, now());
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* name_;
+    uint64_t    start_;
+};
+
+} // namespace trace
+
+#define _TRACE_CONCAT(a, b) a##b
+#define TRACE_CONCAT(a, b) _TRACE_CONCAT(a, b)
+
+#ifdef TRACING
+    #define TRACE_ZONE(name) const trace::Zone TRACE_CONCAT(trace_zone_, __LINE__){ name }
+#else
+    #define TRACE_ZONE(name)
+#endif // TRACING
+
+#endif // TRACE_HPP
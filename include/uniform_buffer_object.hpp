@@ -12,9 +12,28 @@ struct UNIFORM_BUFFER_OBJECT
     alignas(16) glm::mat4 proj;
 };
 
+// per-draw data of the OpenGL multi-draws, indexed by gl_BaseInstance + gl_DrawID in the vertex shader
+struct DrawData
+{
+    alignas(16) glm::mat4 mvp = glm::mat4(1.0f); // proj * view * model, computed once per frame
+};
+
+// pushed with every draw where push constants exist, no descriptor-bound memory is written per draw
+struct DrawConstants
+{
+    glm::mat4 mvp;
+    uint32_t  draw_index; // the draw's element of the bindless objects[] array
+};
+
 using Position = glm::vec3;
 using Color    = glm::vec4;
 
+// per-object data, one storage buffer per object in the bindless array where descriptor indexing exists
+struct ObjectData
+{
+    alignas(16) Color color = Color(1.0f); // multiplied into the vertex colors
+};
+
 struct Vertex
 {
     Position pos;
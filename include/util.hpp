@@ -2,14 +2,20 @@
 #define UTIL_HPP
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <optional>
 #include <source_location>
 #include <sstream>
+#include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #define IGNORE(expr) static_cast<void>(expr);
 #define _STR(str) #str
@@ -237,6 +243,42 @@ std::basic_string<Char> read_file_contents(const std::basic_string_view<Char>& p
     return read_file_contents(path.data());
 }
 
+// nullopt when the file cannot be read or its size is not a multiple of T
+template<typename T>
+std::optional<std::vector<T>> read_binary_file(const std::filesystem::path& path)
+{
+    std::ifstream ifstream{ path, std::ios::binary | std::ios::ate };
+    if (!ifstream.is_open()) {
+        return std::nullopt;
+    }
+    const auto size = static_cast<size_t>(ifstream.tellg());
+    if (size % sizeof(T) != 0) {
+        return std::nullopt;
+    }
+    std::vector<T> contents(size / sizeof(T));
+    ifstream.seekg(0);
+    if (!ifstream.read(reinterpret_cast<char*>(contents.data()), size)) {
+        return std::nullopt;
+    }
+    return contents;
+}
+
+// written next to the target and renamed over it, so a reader never sees half a file
+inline bool write_binary_file(const std::filesystem::path& path, const void* data, size_t size)
+{
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream ofstream{ tmp_path, std::ios::binary | std::ios::trunc };
+        if (!ofstream.write(static_cast<const char*>(data), size)) {
+            return false;
+        }
+    }
+    std::error_code ec{};
+    std::filesystem::rename(tmp_path, path, ec);
+    return !ec;
+}
+
 template<typename To, typename From>
 constexpr To static_cast_fn(const From& from)
 {
@@ -249,6 +291,86 @@ size_t contained_data_size(const Container& cont)
     return cont.size() * sizeof(Container::value_type);
 }
 
+template<typename T>
+void hash_combine(size_t& seed, const T& value)
+{
+    seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+}
+
+// unlike std::hash the result is the same across runs and builds, so it can name things on disk
+constexpr uint64_t fnv1a(std::string_view data, uint64_t hash = 0xcbf29ce484222325)
+{
+    for (const auto c : data) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+// object representation of a trivially copyable value, e.g. to hash it
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+std::string_view as_bytes(const T& value)
+{
+    return { reinterpret_cast<const char*>(&value), sizeof(T) };
+}
+
+// calls write(offset, size) for every run of Granularity sized chunks where current differs from previous
+// and copies them into previous, returns the number of bytes written
+template<size_t Granularity = 16, typename T, typename F>
+    requires std::is_trivially_copyable_v<T>
+size_t copy_changed_ranges(const T& current, T& previous, F&& write)
+{
+    const auto* src = reinterpret_cast<const char*>(&current);
+    auto* dst = reinterpret_cast<char*>(&previous);
+    const auto changed = [src, dst](size_t offset) {
+        return std::memcmp(src + offset, dst + offset, std::min(Granularity, sizeof(T) - offset)) != 0;
+    };
+
+    size_t written = 0;
+    for (size_t offset = 0; offset < sizeof(T); offset += Granularity) {
+        if (!changed(offset)) {
+            continue;
+        }
+        size_t end = offset + Granularity;
+        while (end < sizeof(T) && changed(end)) {
+            end += Granularity;
+        }
+        const auto size = std::min(end, sizeof(T)) - offset;
+        write(offset, size);
+        std::memcpy(dst + offset, src + offset, size);
+        written += size;
+        offset = end;
+    }
+    return written;
+}
+
+// stable LSD radix sort of (key, value) pairs, one byte per pass; passes where every key shares the byte are skipped
+template<typename T>
+void radix_sort(std::vector<std::pair<uint64_t, T>>& items, std::vector<std::pair<uint64_t, T>>& scratch)
+{
+    constexpr uint32_t RadixBits = 8;
+    constexpr uint32_t BucketCount = 1u << RadixBits;
+
+    scratch.resize(items.size());
+    for (uint32_t shift = 0; shift != 64; shift += RadixBits) {
+        std::array<size_t, BucketCount> offsets{};
+        for (const auto& item : items) {
+            ++offsets[(item.first >> shift) & (BucketCount - 1)];
+        }
+        if (std::ranges::any_of(offsets, [size = items.size()](size_t count) { return count == size; })) {
+            continue;
+        }
+        size_t offset = 0;
+        for (auto& count : offsets) {
+            offset += std::exchange(count, offset);
+        }
+        for (const auto& item : items) {
+            scratch[offsets[(item.first >> shift) & (BucketCount - 1)]++] = item;
+        }
+        items.swap(scratch);
+    }
+}
+
 template<typename String, String::value_type delim>
 class sliding_window_iterator_adaptor
 {
@@ -380,6 +502,30 @@ constexpr std::string_view string_to<std::string_view>(std::string_view v)
     return v;
 }
 
+template<>
+constexpr bool string_to<bool>(std::string_view v)
+{
+    if (v == "true") {
+        return true;
+    }
+    if (v == "false") {
+        return false;
+    }
+    return string_to<unsigned long long>(v) != 0;
+}
+
+inline std::string json_escape(std::string_view s)
+{
+    std::string escaped;
+    for (const auto c : s) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
 template<typename Offset, typename Struct, typename Field>
 constexpr Offset field_offset(Field Struct::* field)
 {
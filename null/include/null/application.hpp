@@ -0,0 +1,21 @@
+#ifndef NULL_APPLICATION_HPP
+#define NULL_APPLICATION_HPP
+
+#include "config.hpp"
+#include "framework.hpp"
+#include "window.hpp"
+
+namespace null {
+
+class Application : public impl::Application
+{
+public:
+    DLL_EXPORT static Ptr<Application> create() noexcept;
+
+private:
+    Application() noexcept;
+};
+
+} // namespace null
+
+#endif // NULL_APPLICATION_HPP
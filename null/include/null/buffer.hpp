@@ -0,0 +1,35 @@
+#ifndef NULL_BUFFER_HPP
+#define NULL_BUFFER_HPP
+
+#include "config.hpp"
+#include "framework.hpp"
+
+namespace null {
+
+enum class BufferUsage
+{
+      Vertex
+    , Index
+    , Storage
+};
+
+class BufferHandle : public impl::BufferHandle
+{
+protected:
+    BufferHandle() noexcept = default;
+};
+
+// the items live in impl::Buffer::storage_, there is no device copy to tell the usage to
+template<typename T>
+class Buffer : public BufferHandle, public impl::Buffer<T>
+{
+public:
+    DLL_EXPORT static Ptr<Buffer> create(BufferUsage usage, const typename impl::Buffer<T>::Container& items) noexcept;
+
+protected:
+    Buffer(const typename impl::Buffer<T>::Container& items) noexcept;
+};
+
+} // namespace null
+
+#endif // NULL_BUFFER_HPP
@@ -0,0 +1,81 @@
+#ifndef NULL_COMMAND_QUEUE
+#define NULL_COMMAND_QUEUE
+
+#include <vector>
+
+#include "compute_pipeline.hpp"
+#include "framework.hpp"
+#include "geometry_pool.hpp"
+#include "pipeline.hpp"
+#include "uniform_buffer_object.hpp"
+
+namespace null {
+
+// does the CPU side of what the OpenGL queue does: sorting, state tracking and staging the per-draw data
+class CommandQueue : public impl::CommandQueue
+{
+    friend class DispatchCommand;
+    friend class DrawCommand;
+    friend class Window;
+
+public:
+    DLL_EXPORT static Ptr<CommandQueue> create(const impl::Pipeline& pipeline);
+    DLL_EXPORT void addCommand(impl::Command& command) override;
+
+private:
+    CommandQueue() = default;
+
+private:
+    std::vector<impl::Command*> commands_;
+    const void*                 bound_pipeline_ = nullptr;
+    const GeometryPoolHandle*   bound_geometry_ = nullptr;
+    std::vector<DrawData>       draw_data_;
+};
+
+class ClearCommand : public impl::Command
+{
+public:
+    DLL_EXPORT static Ptr<ClearCommand> create() noexcept;
+    DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
+
+private:
+    ClearCommand() = default;
+};
+
+class DispatchCommand : public impl::Command
+{
+public:
+    DLL_EXPORT static Ptr<DispatchCommand> create(const impl::ComputePipeline& pipeline, uint32_t x, uint32_t y = 1, uint32_t z = 1) noexcept;
+    DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
+
+private:
+    DispatchCommand(const ComputePipeline& pipeline) noexcept;
+
+private:
+    const ComputePipeline& pipeline_;
+};
+
+class DrawCommand : public impl::DrawCommand
+{
+public:
+    DLL_EXPORT static Ptr<DrawCommand> create(
+          const impl::Pipeline&           pipeline
+        , const impl::GeometryPoolHandle& geometry
+        , const impl::GeometryRange&      range) noexcept;
+    DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
+
+    DrawData& drawData() { return draw_data_; }
+
+private:
+    DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry, const impl::GeometryRange& range) noexcept;
+
+private:
+    const Pipeline&           pipeline_;
+    const GeometryPoolHandle& geometry_;
+    const impl::GeometryRange range_;
+    DrawData                  draw_data_;
+};
+
+} // namespace null
+
+#endif // NULL_COMMAND_QUEUE
@@ -0,0 +1,31 @@
+#ifndef NULL_COMPUTE_PIPELINE_HPP
+#define NULL_COMPUTE_PIPELINE_HPP
+
+#include <vector>
+
+#include "buffer.hpp"
+#include "framework.hpp"
+#include "glsl_shader.hpp"
+
+namespace null {
+
+class ComputePipeline : public impl::ComputePipeline
+{
+public:
+    DLL_EXPORT static Ptr<ComputePipeline> create() noexcept;
+
+    DLL_EXPORT void setShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants = {}) override;
+    DLL_EXPORT void addStorageBuffer(uint32_t binding, const impl::BufferHandle& buffer) override;
+    DLL_EXPORT bool use() override;
+
+private:
+    ComputePipeline() noexcept = default;
+
+private:
+    const GlslShader*                                    shader_ = nullptr;
+    std::vector<std::pair<uint32_t, const BufferHandle*>> storage_buffers_; // binding, buffer
+};
+
+} // namespace null
+
+#endif // NULL_COMPUTE_PIPELINE_HPP
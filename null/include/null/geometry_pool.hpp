@@ -0,0 +1,28 @@
+#ifndef NULL_GEOMETRY_POOL_HPP
+#define NULL_GEOMETRY_POOL_HPP
+
+#include "framework.hpp"
+
+namespace null {
+
+class GeometryPoolHandle : public impl::GeometryPoolHandle
+{
+protected:
+    GeometryPoolHandle() noexcept = default;
+};
+
+template<typename V>
+class GeometryPool : public GeometryPoolHandle, public impl::GeometryPool<V>
+{
+public:
+    DLL_EXPORT static Ptr<GeometryPool> create() noexcept;
+
+private:
+    GeometryPool() noexcept = default;
+
+    bool upload(size_t first_vertex, size_t first_index) override;
+};
+
+} // namespace null
+
+#endif // NULL_GEOMETRY_POOL_HPP
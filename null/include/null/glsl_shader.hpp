@@ -0,0 +1,34 @@
+#ifndef NULL_GLSL_SHADER_HPP
+#define NULL_GLSL_SHADER_HPP
+
+#include "framework.hpp"
+
+namespace null {
+
+enum class ShaderType
+{
+      Vertex
+    , Fragment
+    , Compute
+};
+
+// the source is read like the OpenGL backend does, it is never compiled
+class GlslShader : public impl::GlslShader
+{
+    friend class ComputePipeline;
+    friend class Pipeline;
+
+public:
+    DLL_EXPORT static Ptr<GlslShader> create(ShaderType type, std::string_view path) noexcept;
+
+private:
+    GlslShader(ShaderType type, std::string_view path) noexcept;
+
+private:
+    const ShaderType  type_;
+    const std::string source_;
+};
+
+} // namespace null
+
+#endif // NULL_GLSL_SHADER_HPP
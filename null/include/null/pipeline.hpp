@@ -0,0 +1,26 @@
+#ifndef NULL_PIPELINE_HPP
+#define NULL_PIPELINE_HPP
+
+#include "framework.hpp"
+#include "glsl_shader.hpp"
+
+namespace null {
+
+class Pipeline : public impl::Pipeline
+{
+public:
+    DLL_EXPORT static Ptr<Pipeline> create() noexcept;
+
+    DLL_EXPORT void addShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants = {}) override;
+    DLL_EXPORT bool use(const impl::VertexDescription& description) override;
+
+private:
+    Pipeline() noexcept = default;
+
+private:
+    std::vector<const GlslShader*> shaders_;
+};
+
+} // namespace null
+
+#endif // NULL_PIPELINE_HPP
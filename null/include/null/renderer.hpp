@@ -0,0 +1,18 @@
+#ifndef NULL_RENDERER_HPP
+#define NULL_RENDERER_HPP
+
+#include "renderer_def.hpp"
+
+namespace null {
+
+class Renderer : public impl::Renderer
+{
+public:
+    DLL_EXPORT static Ptr<impl::Renderer> create() noexcept;
+    DLL_EXPORT static impl::Window& getWindow() noexcept;
+    DLL_EXPORT void run() override;
+};
+
+} // namespace null
+
+#endif // NULL_RENDERER_HPP
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef NULL_UNIFORM_BLOCK_HPP
+#define NULL_UNIFORM_BLOCK_HPP
+
+#include "framework.hpp"
+
+namespace null {
+
+// changes are tracked as on a GPU backend, the ranges that would be uploaded are only counted
+template<typename UBO>
+class UniformBlock : public impl::UniformBlock<UBO>, public impl::BufferHandle
+{
+public:
+    DLL_EXPORT static Ptr<UniformBlock> create(impl::GlslShader&, const char* uniform_block_name, uint32_t binding);
+
+    DLL_EXPORT void update() override;
+    DLL_EXPORT UBO& get() override;
+
+private:
+    UniformBlock() noexcept = default;
+
+private:
+    UBO ubo_;
+    UBO uploaded_;
+    bool initialized_ = false;
+};
+
+} // namespace null
+
+#endif // NULL_UNIFORM_BLOCK_HPP
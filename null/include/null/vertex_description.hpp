@@ -0,0 +1,28 @@
+#ifndef NULL_VERTEX_DESCRIPTION_HPP
+#define NULL_VERTEX_DESCRIPTION_HPP
+
+#include <vector>
+
+#include "framework.hpp"
+#include "vertex_attribute.hpp"
+
+namespace null {
+
+class VertexDescription : public impl::VertexDescription
+{
+    friend class Pipeline;
+
+public:
+    DLL_EXPORT static Ptr<VertexDescription> create() noexcept;
+    DLL_EXPORT void addAttribute(const impl::VertexAttribute& attribute) override;
+
+private:
+    VertexDescription() noexcept = default;
+
+private:
+    std::vector<details::VertexAttributeFormat> attributes_;
+};
+
+} // namespace null
+
+#endif // NULL_VERTEX_DESCRIPTION_HPP
@@ -0,0 +1,22 @@
+#ifndef NULL_WINDOW_HPP
+#define NULL_WINDOW_HPP
+
+#include "framework.hpp"
+
+namespace null {
+
+// always headless, there is nothing to show
+class Window : public impl::Window
+{
+public:
+    DLL_EXPORT static Ptr<Window> create(uint32_t width, uint32_t height, std::string_view title) noexcept;
+
+    DLL_EXPORT void swapFramebuffers(impl::CommandQueue& queue) override;
+
+private:
+    Window(uint32_t width, uint32_t height, std::string_view title) noexcept;
+};
+
+} // namespace null
+
+#endif // NULL_WINDOW_HPP
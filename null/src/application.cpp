@@ -0,0 +1,15 @@
+#include "null/application.hpp"
+
+namespace null {
+
+DLL_EXPORT Ptr<Application> Application::create() noexcept
+{
+    return Ptr<Application>{ new Application{} };
+}
+
+Application::Application() noexcept
+{
+    std::cout << "Null backend: no GPU calls, frame times are framework overhead only\n";
+}
+
+} // namespace null
@@ -0,0 +1,21 @@
+#include "model.hpp"
+
+#include "null/buffer.hpp"
+
+namespace null {
+
+template<typename T>
+DLL_EXPORT Ptr<Buffer<T>> Buffer<T>::create(BufferUsage usage, const typename impl::Buffer<T>::Container& items) noexcept
+{
+    return Ptr<Buffer>{ new Buffer{ items } };
+}
+
+template<typename T>
+Buffer<T>::Buffer(const typename impl::Buffer<T>::Container& items) noexcept
+    : impl::Buffer<T>{ items }
+{}
+
+template class Buffer<Vertex>;
+template class Buffer<uint32_t>;
+
+} // namespace null
@@ -0,0 +1,72 @@
+#include "null/command_queue.hpp"
+
+namespace null {
+
+DLL_EXPORT Ptr<CommandQueue> CommandQueue::create(const impl::Pipeline& pipeline)
+{
+    return Ptr<CommandQueue>{ new CommandQueue{} };
+}
+
+DLL_EXPORT void CommandQueue::addCommand(impl::Command& command)
+{
+    commands_.push_back(&command);
+}
+
+DLL_EXPORT Ptr<ClearCommand> ClearCommand::create() noexcept
+{
+    return Ptr<ClearCommand>{ new ClearCommand{} };
+}
+
+DLL_EXPORT void ClearCommand::operator()(impl::CommandQueue& queue)
+{
+    // read every frame like the OpenGL backend does, the lookup is part of the overhead
+    auto clear_color = *Config::instance().get<std::vector, float>("clear_color");
+    for (auto& component : clear_color) {
+        component /= 256.0;
+    }
+}
+
+DLL_EXPORT Ptr<DispatchCommand> DispatchCommand::create(const impl::ComputePipeline& pipeline, uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+    return Ptr<DispatchCommand>{ new DispatchCommand{ dynamic_cast<const ComputePipeline&>(pipeline) } };
+}
+
+DLL_EXPORT void DispatchCommand::operator()(impl::CommandQueue& queue)
+{
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    IGNORE(q.changeState(q.bound_pipeline_, static_cast<const void*>(&pipeline_), &impl::FrameStats::pipeline_binds));
+}
+
+DispatchCommand::DispatchCommand(const ComputePipeline& pipeline) noexcept
+    : pipeline_{ pipeline }
+{}
+
+DLL_EXPORT Ptr<DrawCommand> DrawCommand::create(
+      const impl::Pipeline&           pipeline
+    , const impl::GeometryPoolHandle& geometry
+    , const impl::GeometryRange&      range) noexcept
+{
+    return Ptr<DrawCommand>{ new DrawCommand{
+          dynamic_cast<const Pipeline&>(pipeline)
+        , dynamic_cast<const GeometryPoolHandle&>(geometry)
+        , range
+    } };
+}
+
+DLL_EXPORT void DrawCommand::operator()(impl::CommandQueue& queue)
+{
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    IGNORE(q.changeState(q.bound_pipeline_, static_cast<const void*>(&pipeline_), &impl::FrameStats::pipeline_binds));
+    IGNORE(q.changeState(q.bound_geometry_, &geometry_, &impl::FrameStats::buffer_binds));
+    q.countDraw(range_.index_count);
+    q.draw_data_.push_back(draw_data_);
+}
+
+DrawCommand::DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry, const impl::GeometryRange& range) noexcept
+    : impl::DrawCommand{ pipeline, geometry }
+    , pipeline_{ pipeline }
+    , geometry_{ geometry }
+    , range_{ range }
+{}
+
+} // namespace null
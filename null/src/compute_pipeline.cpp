@@ -0,0 +1,28 @@
+#include "null/compute_pipeline.hpp"
+
+namespace null {
+
+DLL_EXPORT Ptr<ComputePipeline> ComputePipeline::create() noexcept
+{
+    return Ptr<ComputePipeline>{ new ComputePipeline{} };
+}
+
+DLL_EXPORT void ComputePipeline::setShader(const impl::GlslShader& shader, const impl::SpecializationConstants&)
+{
+    shader_ = &dynamic_cast<const GlslShader&>(shader);
+}
+
+DLL_EXPORT void ComputePipeline::addStorageBuffer(uint32_t binding, const impl::BufferHandle& buffer)
+{
+    storage_buffers_.emplace_back(binding, &dynamic_cast<const BufferHandle&>(buffer));
+}
+
+DLL_EXPORT bool ComputePipeline::use()
+{
+    if (!shader_ || shader_->type_ != ShaderType::Compute) {
+        return util::handle_error() << "Compute pipeline needs a compute shader";
+    }
+    return true;
+}
+
+} // namespace null
@@ -0,0 +1,10 @@
+#include "null/debug_info.hpp"
+
+namespace null {
+
+DLL_EXPORT Ptr<DebugInfo> DebugInfo::create(const impl::Application&) noexcept
+{
+    return Ptr<DebugInfo>{ new DebugInfo{} };
+}
+
+} // namespace null
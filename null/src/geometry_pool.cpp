@@ -0,0 +1,22 @@
+#include "model.hpp"
+
+#include "null/geometry_pool.hpp"
+
+namespace null {
+
+template<typename V>
+DLL_EXPORT Ptr<GeometryPool<V>> GeometryPool<V>::create() noexcept
+{
+    return Ptr<GeometryPool>{ new GeometryPool{} };
+}
+
+template<typename V>
+bool GeometryPool<V>::upload(size_t first_vertex, size_t first_index)
+{
+    // the geometry stays in impl::GeometryPool, there is no device memory to copy it to
+    return true;
+}
+
+template class GeometryPool<Vertex>;
+
+} // namespace null
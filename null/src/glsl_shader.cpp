@@ -0,0 +1,19 @@
+#include "null/glsl_shader.hpp"
+
+namespace null {
+
+DLL_EXPORT Ptr<GlslShader> GlslShader::create(ShaderType type, std::string_view path) noexcept
+{
+    auto shader = Ptr<GlslShader>{ new GlslShader{ type, path } };
+    if (shader->source_.empty()) {
+        return util::handle_error() << "Failed to read " << path;
+    }
+    return shader;
+}
+
+GlslShader::GlslShader(ShaderType type, std::string_view path) noexcept
+    : type_{ type }
+    , source_{ util::read_file_contents(path) }
+{}
+
+} // namespace null
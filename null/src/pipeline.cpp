@@ -0,0 +1,26 @@
+#include "null/pipeline.hpp"
+
+namespace null {
+
+DLL_EXPORT Ptr<Pipeline> Pipeline::create() noexcept
+{
+    return Ptr<Pipeline>{ new Pipeline{} };
+}
+
+DLL_EXPORT void Pipeline::addShader(const impl::GlslShader& shader, const impl::SpecializationConstants&)
+{
+    shaders_.push_back(&dynamic_cast<const GlslShader&>(shader));
+}
+
+DLL_EXPORT bool Pipeline::use(const impl::VertexDescription&)
+{
+    const auto has_stage = [this](ShaderType type) {
+        return std::ranges::find(shaders_, type, &GlslShader::type_) != shaders_.end();
+    };
+    if (!has_stage(ShaderType::Vertex) || !has_stage(ShaderType::Fragment)) {
+        return util::handle_error() << "Pipeline needs a vertex and a fragment shader";
+    }
+    return true;
+}
+
+} // namespace null
@@ -0,0 +1,3 @@
+#define NULL_BACKEND
+#include "null/renderer.hpp"
+#include "renderer_impl.hpp"
\ No newline at end of file
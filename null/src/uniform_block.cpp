@@ -0,0 +1,36 @@
+#include "constants.h"
+#include "model.hpp"
+#include "trace.hpp"
+
+#include "null/uniform_block.hpp"
+
+namespace null {
+
+template<typename UBO>
+DLL_EXPORT Ptr<UniformBlock<UBO>> UniformBlock<UBO>::create(impl::GlslShader&, const char* uniform_block_name, uint32_t binding)
+{
+    return Ptr<UniformBlock>{ new UniformBlock{} };
+}
+
+template<typename UBO>
+DLL_EXPORT void UniformBlock<UBO>::update()
+{
+    TRACE_ZONE("UniformBlock::update");
+    if (!initialized_) {
+        uploaded_ = ubo_;
+        initialized_ = true;
+        impl::UniformBlock<UBO>::uploaded_bytes_ = sizeof(UBO);
+        return;
+    }
+    impl::UniformBlock<UBO>::uploaded_bytes_ = util::copy_changed_ranges(ubo_, uploaded_, [](size_t, size_t) {});
+}
+
+template<typename UBO>
+DLL_EXPORT UBO& UniformBlock<UBO>::get()
+{
+    return ubo_;
+}
+
+template class UniformBlock<UNIFORM_BUFFER_OBJECT>;
+
+} // namespace null
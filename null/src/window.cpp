@@ -0,0 +1,30 @@
+#include "trace.hpp"
+
+#include "null/command_queue.hpp"
+#include "null/window.hpp"
+
+namespace null {
+
+DLL_EXPORT Ptr<Window> Window::create(uint32_t width, uint32_t height, std::string_view title) noexcept
+{
+    return Ptr<Window>{ new Window{ width, height, title } };
+}
+
+DLL_EXPORT void Window::swapFramebuffers(impl::CommandQueue& queue)
+{
+    TRACE_ZONE("Window::swapFramebuffers");
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    q.bound_pipeline_ = nullptr;
+    q.bound_geometry_ = nullptr;
+    q.draw_data_.clear();
+    q.sortCommands(q.commands_);
+    for (const auto& command : q.commands_) {
+        (*command)(q);
+    }
+}
+
+Window::Window(uint32_t width, uint32_t height, std::string_view title) noexcept
+    : impl::Window{ width, height, title, {}, true }
+{}
+
+} // namespace null
@@ -14,6 +14,9 @@ public:
 
 private:
     Application() noexcept;
+
+    // works without GLFW, for headless contexts too
+    static bool extensionSupported(std::string_view name);
 };
 
 } // namespace opengl
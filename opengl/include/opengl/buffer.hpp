@@ -10,10 +10,12 @@ enum class BufferUsage
 {
       Vertex = GL_ARRAY_BUFFER
     , Index = GL_ELEMENT_ARRAY_BUFFER
+    , Storage = GL_SHADER_STORAGE_BUFFER
 };
 
 class BufferHandle : public impl::BufferHandle
 {
+    friend class ComputePipeline;
     friend class DrawCommand;
 
 protected:
@@ -22,6 +24,10 @@ protected:
         , elem_count_{ static_cast<GLuint>(elem_count) }
     {}
 
+protected:
+    GLuint                  buffer_ = 0;
+    MemoryStats::Allocation device_memory_;
+
 private:
     const GLenum target_;
     const GLuint elem_count_;
@@ -35,9 +41,6 @@ public:
 
 protected:
     Buffer(GLenum target, const typename impl::Buffer<T>::Container& items) noexcept;
-
-private:
-    GLuint buffer_;
 };
 
 } // namespace opengl
@@ -4,20 +4,59 @@
 #include <vector>
 
 #include "buffer.hpp"
+#include "compute_pipeline.hpp"
 #include "framework.hpp"
+#include "geometry_pool.hpp"
+#include "pipeline.hpp"
+#include "uniform_buffer_object.hpp"
 
 namespace opengl {
+namespace details {
+
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint  base_vertex;
+    GLuint base_instance;
+};
+
+} // namespace details
 
 class CommandQueue : public impl::CommandQueue
 {
+    friend class ClearCommand;
+    friend class DispatchCommand;
+    friend class DrawCommand;
     friend class Window;
 
 public:
     DLL_EXPORT static Ptr<CommandQueue> create(const impl::Pipeline& pipeline);
+    DLL_EXPORT ~CommandQueue();
     DLL_EXPORT void addCommand(impl::Command& command) override;
 
+private:
+    CommandQueue() = default;
+
+    bool reserveDraws(size_t count);
+    void pushDraw(const impl::GeometryRange& range, const DrawData& draw_data);
+    void flushDraws();
+
 private:
     std::vector<impl::Command*> commands_;
+    GLuint                      bound_program_ = 0;
+    const GeometryPoolHandle*   bound_geometry_ = nullptr;
+    bool                        cleared_ = false; // dispatches are refused after the clear, as in the Vulkan render pass
+
+    GLuint                                indirect_buffer_ = 0;
+    GLuint                                draw_data_buffer_ = 0;
+    details::DrawElementsIndirectCommand* mapped_indirect_commands_ = nullptr;
+    DrawData*                             mapped_draw_data_ = nullptr;
+    size_t                                draw_capacity_ = 0;
+    size_t                                draw_count_ = 0;
+    size_t                                batch_first_ = 0;
+    MemoryStats::Allocation               draw_memory_;
 };
 
 class ClearCommand : public impl::Command
@@ -30,17 +69,40 @@ private:
     ClearCommand() = default;
 };
 
-class DrawCommand : public impl::Command
+// has to come before the ClearCommand, the same order the Vulkan backend needs
+class DispatchCommand : public impl::Command
+{
+public:
+    DLL_EXPORT static Ptr<DispatchCommand> create(const impl::ComputePipeline& pipeline, uint32_t x, uint32_t y = 1, uint32_t z = 1) noexcept;
+    DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
+
+private:
+    DispatchCommand(const ComputePipeline& pipeline, uint32_t x, uint32_t y, uint32_t z) noexcept;
+
+private:
+    const ComputePipeline& pipeline_;
+    const GLuint           x_, y_, z_;
+};
+
+class DrawCommand : public impl::DrawCommand
 {
 public:
-    DLL_EXPORT static Ptr<DrawCommand> create(const impl::BufferHandle& vertex_buffer, const impl::BufferHandle& index_buffer) noexcept;
+    DLL_EXPORT static Ptr<DrawCommand> create(
+          const impl::Pipeline&           pipeline
+        , const impl::GeometryPoolHandle& geometry
+        , const impl::GeometryRange&      range) noexcept;
     DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
 
+    DrawData& drawData() { return draw_data_; }
+
 private:
-    DrawCommand(const BufferHandle& vertex_buffer) noexcept;
+    DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry, const impl::GeometryRange& range) noexcept;
 
 private:
-    const BufferHandle& vertex_buffer_;
+    const Pipeline&           pipeline_;
+    const GeometryPoolHandle& geometry_;
+    const impl::GeometryRange range_;
+    DrawData                  draw_data_;
 };
 
 } // namespace opengl
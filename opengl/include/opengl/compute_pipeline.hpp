@@ -0,0 +1,37 @@
+#ifndef OPENGL_COMPUTE_PIPELINE_HPP
+#define OPENGL_COMPUTE_PIPELINE_HPP
+
+#include <vector>
+
+#include "buffer.hpp"
+#include "framework.hpp"
+#include "glsl_shader.hpp"
+
+namespace opengl {
+
+class ComputePipeline : public impl::ComputePipeline
+{
+    friend class DispatchCommand;
+
+public:
+    DLL_EXPORT static Ptr<ComputePipeline> create() noexcept;
+    DLL_EXPORT ~ComputePipeline();
+
+    DLL_EXPORT void setShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants = {}) override;
+    DLL_EXPORT void addStorageBuffer(uint32_t binding, const impl::BufferHandle& buffer) override;
+    DLL_EXPORT bool use() override;
+
+private:
+    ComputePipeline() noexcept;
+
+    void bindStorageBuffers() const;
+
+private:
+    GLuint                                 program_;
+    const GlslShader*                      shader_ = nullptr;
+    std::vector<std::pair<GLuint, GLuint>> storage_buffers_; // binding, buffer
+};
+
+} // namespace opengl
+
+#endif // OPENGL_COMPUTE_PIPELINE_HPP
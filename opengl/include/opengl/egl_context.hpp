@@ -0,0 +1,32 @@
+#ifndef OPENGL_EGL_CONTEXT_HPP
+#define OPENGL_EGL_CONTEXT_HPP
+
+#include "framework.hpp"
+
+namespace opengl {
+namespace details {
+
+// windowless context for headless runs, surfaceless when the driver supports it (Mesa does) and on a pbuffer otherwise;
+// frames go to an offscreen framebuffer object either way
+class EglContext
+{
+public:
+    static Ptr<EglContext> create(uint32_t width, uint32_t height) noexcept;
+    ~EglContext();
+
+    static void* getProcAddress(const char* name);
+
+private:
+    EglContext() noexcept;
+
+private:
+    // EGLDisplay, EGLContext and EGLSurface, EGL headers are only needed where the context is made
+    void* display_ = nullptr;
+    void* context_ = nullptr;
+    void* surface_ = nullptr;
+};
+
+} // namespace details
+} // namespace opengl
+
+#endif // OPENGL_EGL_CONTEXT_HPP
@@ -0,0 +1,43 @@
+#ifndef OPENGL_GEOMETRY_POOL_HPP
+#define OPENGL_GEOMETRY_POOL_HPP
+
+#include "framework.hpp"
+
+namespace opengl {
+
+class GeometryPoolHandle : public impl::GeometryPoolHandle
+{
+    friend class DrawCommand;
+
+public:
+    DLL_EXPORT ~GeometryPoolHandle();
+
+protected:
+    GeometryPoolHandle() noexcept;
+
+    static bool write(GLuint buffer, size_t& capacity, const void* data, size_t offset, size_t size);
+    void bind() const;
+
+protected:
+    GLuint                  vertex_buffer_;
+    GLuint                  index_buffer_;
+    size_t                  vertex_capacity_ = 0;
+    size_t                  index_capacity_  = 0;
+    MemoryStats::Allocation device_memory_{ MemoryStats::Heap::Device, MemoryStats::Category::Geometry, 0 };
+};
+
+template<typename V>
+class GeometryPool : public GeometryPoolHandle, public impl::GeometryPool<V>
+{
+public:
+    DLL_EXPORT static Ptr<GeometryPool> create() noexcept;
+
+private:
+    GeometryPool() noexcept = default;
+
+    bool upload(size_t first_vertex, size_t first_index) override;
+};
+
+} // namespace opengl
+
+#endif // OPENGL_GEOMETRY_POOL_HPP
@@ -14,23 +14,33 @@ enum class ShaderType : GLenum
 {
       Vertex = GL_VERTEX_SHADER
     , Fragment = GL_FRAGMENT_SHADER
+    , Compute = GL_COMPUTE_SHADER
 };
 
 class GlslShader : public impl::GlslShader
 {
+    friend class ComputePipeline;
     friend class Pipeline;
     friend class details::UniformBlockBase;
 
 public:
     DLL_EXPORT static Ptr<GlslShader> create(ShaderType type, std::string_view path) noexcept;
+    DLL_EXPORT ~GlslShader();
 
 private:
     GlslShader(GLenum type, std::string_view path) noexcept;
 
+    // deferred to the pipeline, which skips it when the linked program comes from the binary cache;
+    // the status is queried separately so the driver can compile every stage before anyone waits on one
+    void compile() const;
+    bool checkCompileStatus() const;
+
 private:
-    GLuint shader_;
-    GLenum type_;
-    GLuint program_ = 0;
+    mutable GLuint          shader_ = 0;
+    const GLenum            type_;
+    const std::string       source_;
+    GLuint                  program_ = 0;
+    MemoryStats::Allocation source_memory_;
 };
 
 } // namespace opengl
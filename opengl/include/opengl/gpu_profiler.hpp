@@ -0,0 +1,54 @@
+#ifndef OPENGL_GPU_PROFILER_HPP
+#define OPENGL_GPU_PROFILER_HPP
+
+#include <array>
+
+#include "framework.hpp"
+
+namespace opengl {
+namespace details {
+
+// a frame's queries are read back when its slot in the ring comes round again, by then the glFinish
+// of later frames has long made them available
+class GpuProfiler : public impl::GpuProfiler
+{
+    static constexpr uint32_t FrameCount = 4;
+    static constexpr std::array<GLenum, 5> StatisticTargets{
+          GL_PRIMITIVES_SUBMITTED
+        , GL_VERTEX_SHADER_INVOCATIONS
+        , GL_CLIPPING_INPUT_PRIMITIVES
+        , GL_CLIPPING_OUTPUT_PRIMITIVES
+        , GL_FRAGMENT_SHADER_INVOCATIONS
+    };
+
+public:
+    // needs the GL functions loaded, statistics need GL 4.6 or ARB_pipeline_statistics_query
+    static Ptr<GpuProfiler> create(bool statistics) noexcept;
+    ~GpuProfiler();
+
+    void begin();
+    void end();
+
+private:
+    struct Queries
+    {
+        std::array<GLuint, 2>                        timestamps{}; // frame begin and end
+        std::array<GLuint, StatisticTargets.size()> statistics{};
+        bool                                         recorded = false;
+    };
+
+    GpuProfiler(bool statistics) noexcept;
+
+    void collect(Queries& queries);
+    static bool available(GLuint query);
+
+private:
+    const bool                      statistics_;
+    std::array<Queries, FrameCount> frames_;
+    uint32_t                        current_frame_ = 0;
+};
+
+} // namespace details
+} // namespace opengl
+
+#endif // OPENGL_GPU_PROFILER_HPP
@@ -1,6 +1,7 @@
 #ifndef OPENGL_PROGRAM_HPP
 #define OPENGL_PROGRAM_HPP
 
+#include <filesystem>
 #include <vector>
 
 #include "framework.hpp"
@@ -23,19 +24,28 @@ protected:
 class Pipeline : public impl::Pipeline
 {
     friend class details::UniformBlockBase;
+    friend class DrawCommand;
 
 public:
     DLL_EXPORT static Ptr<Pipeline> create() noexcept;
 
-    DLL_EXPORT void addShader(const impl::GlslShader& shader) override;
+    DLL_EXPORT void addShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants = {}) override;
     DLL_EXPORT bool use(const impl::VertexDescription& description) override;
 
 private:
     Pipeline() noexcept;
     static constexpr GLbitfield GetShaderTypeBit(GLenum bit);
 
+    bool link();
+
+    // empty when the binary cache is disabled or the driver has no binary formats
+    std::filesystem::path getProgramBinaryPath() const;
+    bool loadProgramBinary(const std::filesystem::path& path);
+    bool storeProgramBinary(const std::filesystem::path& path) const;
+
 private:
-    GLuint program_;
+    GLuint                program_;
+    std::filesystem::path cache_dir_;
     std::vector<const impl::GlslShader*> shaders_;
 };
 
@@ -19,8 +19,11 @@ private:
     UniformBlock() noexcept;
 
 private:
-    GLuint buffer_;
-    UBO ubo_;
+    GLuint                  buffer_;
+    UBO                     ubo_;
+    UBO                     uploaded_;
+    bool                    initialized_ = false;
+    MemoryStats::Allocation device_memory_;
 };
 
 } // namespace opengl
@@ -1,18 +1,36 @@
 #ifndef OPENGL_WINDOW_HPP
 #define OPENGL_WINDOW_HPP
 
+#include "egl_context.hpp"
 #include "framework.hpp"
+#include "gpu_profiler.hpp"
 
 namespace opengl {
 
 class Window : public impl::Window
 {
+    friend class Application;
+
 public:
     DLL_EXPORT static Ptr<Window> create(uint32_t width, uint32_t height, std::string_view title) noexcept;
+    DLL_EXPORT ~Window();
+
     DLL_EXPORT void swapFramebuffers(impl::CommandQueue& queue) override;
+    DLL_EXPORT const impl::GpuProfiler* gpuProfiler() const override { return gpu_profiler_.get(); }
+
+private:
+    Window(uint32_t width, uint32_t height, std::string_view title, bool headless) noexcept;
+
+    // headless frames are drawn here, needs the GL functions loaded
+    bool createOffscreenFramebuffer();
 
 private:
-    Window(uint32_t width, uint32_t height, std::string_view title) noexcept;
+    Ptr<details::EglContext>  egl_context_; // headless only
+    GLuint                    framebuffer_ = 0;
+    GLuint                    color_renderbuffer_ = 0;
+    GLuint                    depth_renderbuffer_ = 0;
+    MemoryStats::Allocation   renderbuffer_memory_;
+    Ptr<details::GpuProfiler> gpu_profiler_; // null unless gpu_profiler is set in the config
 };
 
 } // namespace opengl
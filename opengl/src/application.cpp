@@ -2,14 +2,38 @@
 #include <glfw/glfw3.h>
 
 #include "opengl/application.hpp"
+#include "opengl/renderer.hpp"
 
 namespace opengl {
 
 DLL_EXPORT Ptr<Application> Application::create() noexcept
 {
-    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+    auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    const auto get_proc_address = window.headless()
+        ? reinterpret_cast<GLADloadproc>(details::EglContext::getProcAddress)
+        : reinterpret_cast<GLADloadproc>(glfwGetProcAddress);
+    if (!gladLoadGLLoader(get_proc_address)) {
         return util::handle_error();
     }
+    if (window.headless() && !window.createOffscreenFramebuffer()) {
+        return util::handle_error();
+    }
+    if (Config::instance().get<bool>("gpu_profiler").value_or(false)) {
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        const auto statistics = major > 4 || (major == 4 && minor >= 6) || extensionSupported("GL_ARB_pipeline_statistics_query");
+        window.gpu_profiler_ = details::GpuProfiler::create(statistics);
+    }
+
+    // lets the driver compile shaders on its own threads, glCompileShader then returns without waiting
+    if (extensionSupported("GL_KHR_parallel_shader_compile")) {
+        using MaxShaderCompilerThreadsProc = void (APIENTRY*)(GLuint);
+        const auto max_shader_compiler_threads = reinterpret_cast<MaxShaderCompilerThreadsProc>(get_proc_address("glMaxShaderCompilerThreadsKHR"));
+        if (max_shader_compiler_threads) {
+            max_shader_compiler_threads(0xFFFFFFFF); // as many threads as the implementation likes
+        }
+    }
     return Ptr<Application>{ new Application{} };
 }
 
@@ -18,4 +42,16 @@ Application::Application() noexcept
     std::cout << "OpenGL version: " << glGetString(GL_VERSION) << '\n';
 }
 
+bool Application::extensionSupported(std::string_view name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i != count; ++i) {
+        if (name == reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace opengl
\ No newline at end of file
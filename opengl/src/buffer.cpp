@@ -20,6 +20,8 @@ Buffer<T>::Buffer(GLenum target, const typename impl::Buffer<T>::Container& item
     glCreateBuffers(1, &buffer_);
     glBindBuffer(target, buffer_);
     glNamedBufferStorage(buffer_, util::contained_data_size(impl::Buffer<T>::storage_), impl::Buffer<T>::storage_.data(), GL_MAP_READ_BIT);
+    const auto category = target == GL_SHADER_STORAGE_BUFFER ? MemoryStats::Category::Uniforms : MemoryStats::Category::Geometry;
+    device_memory_ = { MemoryStats::Heap::Device, category, items.size() * sizeof(T) };
 }
 
 template class Buffer<Vertex>;
@@ -1,5 +1,7 @@
 #include <glad/glad.h>
 
+#include "constants.h"
+
 #include "opengl/command_queue.hpp"
 
 namespace opengl {
@@ -9,11 +11,84 @@ DLL_EXPORT Ptr<CommandQueue> CommandQueue::create(const impl::Pipeline& pipeline
     return Ptr<CommandQueue>{new CommandQueue{}};
 }
 
+DLL_EXPORT CommandQueue::~CommandQueue()
+{
+    glDeleteBuffers(1, &draw_data_buffer_);
+    glDeleteBuffers(1, &indirect_buffer_);
+}
+
 DLL_EXPORT void CommandQueue::addCommand(impl::Command& command)
 {
     commands_.push_back(&command);
 }
 
+bool CommandQueue::reserveDraws(size_t count)
+{
+    draw_count_ = 0;
+    batch_first_ = 0;
+    if (count <= draw_capacity_) {
+        return true;
+    }
+
+    // frames end with glFinish, so the old buffers can be dropped right away
+    glDeleteBuffers(1, &draw_data_buffer_);
+    glDeleteBuffers(1, &indirect_buffer_);
+    constexpr size_t MinCapacity = 256;
+    draw_capacity_ = std::max({ count, draw_capacity_ * 2, MinCapacity });
+
+    constexpr GLbitfield MapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const auto indirect_size = draw_capacity_ * sizeof(details::DrawElementsIndirectCommand);
+    glCreateBuffers(1, &indirect_buffer_);
+    glNamedBufferStorage(indirect_buffer_, indirect_size, nullptr, MapFlags);
+    mapped_indirect_commands_ = static_cast<details::DrawElementsIndirectCommand*>(glMapNamedBufferRange(indirect_buffer_, 0, indirect_size, MapFlags));
+
+    const auto draw_data_size = draw_capacity_ * sizeof(DrawData);
+    glCreateBuffers(1, &draw_data_buffer_);
+    glNamedBufferStorage(draw_data_buffer_, draw_data_size, nullptr, MapFlags);
+    mapped_draw_data_ = static_cast<DrawData*>(glMapNamedBufferRange(draw_data_buffer_, 0, draw_data_size, MapFlags));
+
+    if (!mapped_indirect_commands_ || !mapped_draw_data_) {
+        draw_capacity_ = 0;
+        return util::handle_error() << "Failed to map draw buffers";
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer_);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, draw_data_buffer_);
+    frame_stats_.allocations += 2;
+    draw_memory_ = { MemoryStats::Heap::Device, MemoryStats::Category::Staging, indirect_size + draw_data_size };
+    frame_stats_.buffer_binds += 2;
+    return true;
+}
+
+void CommandQueue::pushDraw(const impl::GeometryRange& range, const DrawData& draw_data)
+{
+    mapped_indirect_commands_[draw_count_] = {
+          range.index_count
+        , 1
+        , range.first_index
+        , range.vertex_offset
+        , static_cast<GLuint>(batch_first_)
+    };
+    mapped_draw_data_[draw_count_] = draw_data;
+    ++draw_count_;
+    countDraw(range.index_count);
+    frame_stats_.mapped_bytes += sizeof(details::DrawElementsIndirectCommand) + sizeof(DrawData);
+}
+
+void CommandQueue::flushDraws()
+{
+    if (draw_count_ == batch_first_) {
+        return;
+    }
+    glMultiDrawElementsIndirect(
+          GL_TRIANGLES
+        , GL_UNSIGNED_INT
+        , reinterpret_cast<const void*>(batch_first_ * sizeof(details::DrawElementsIndirectCommand))
+        , static_cast<GLsizei>(draw_count_ - batch_first_)
+        , 0
+    );
+    batch_first_ = draw_count_;
+}
+
 DLL_EXPORT Ptr<ClearCommand> ClearCommand::create() noexcept
 {
     return Ptr<ClearCommand>{new ClearCommand{}};
@@ -27,24 +102,76 @@ DLL_EXPORT void ClearCommand::operator()(impl::CommandQueue& queue)
     }
     glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    dynamic_cast<CommandQueue&>(queue).cleared_ = true;
 }
 
-DLL_EXPORT Ptr<DrawCommand> DrawCommand::create(const impl::BufferHandle& vertex_buffer, const impl::BufferHandle& index_buffer) noexcept
+DLL_EXPORT Ptr<DispatchCommand> DispatchCommand::create(const impl::ComputePipeline& pipeline, uint32_t x, uint32_t y, uint32_t z) noexcept
 {
-    const auto& ib = dynamic_cast<const BufferHandle&>(index_buffer);
-    if (ib.target_ != GL_ELEMENT_ARRAY_BUFFER) {
-        return util::handle_error();
+    return Ptr<DispatchCommand>{ new DispatchCommand{ dynamic_cast<const ComputePipeline&>(pipeline), x, y, z } };
+}
+
+DLL_EXPORT void DispatchCommand::operator()(impl::CommandQueue& queue)
+{
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    if (q.cleared_) {
+        IGNORE(util::handle_error() << "Dispatch added after the clear command, add it before");
+        return;
+    }
+    // pending draws may read what the dispatch is about to overwrite
+    q.flushDraws();
+    if (q.changeState(q.bound_program_, pipeline_.program_, &impl::FrameStats::pipeline_binds)) {
+        glUseProgram(pipeline_.program_);
     }
-    return Ptr<DrawCommand>{ new DrawCommand{ dynamic_cast<const BufferHandle&>(vertex_buffer) } };
+    pipeline_.bindStorageBuffers();
+    glDispatchCompute(x_, y_, z_);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT
+                  | GL_COMMAND_BARRIER_BIT
+                  | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+                  | GL_ELEMENT_ARRAY_BARRIER_BIT
+                  | GL_UNIFORM_BARRIER_BIT);
+    // storage bindings are shared with draws, the per-draw data goes back where the vertex shader expects it
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, q.draw_data_buffer_);
+    ++q.frame_stats_.buffer_binds;
 }
 
-DLL_EXPORT void DrawCommand::operator()(impl::CommandQueue&)
+DispatchCommand::DispatchCommand(const ComputePipeline& pipeline, uint32_t x, uint32_t y, uint32_t z) noexcept
+    : pipeline_{ pipeline }
+    , x_{ x }
+    , y_{ y }
+    , z_{ z }
+{}
+
+DLL_EXPORT Ptr<DrawCommand> DrawCommand::create(
+      const impl::Pipeline&           pipeline
+    , const impl::GeometryPoolHandle& geometry
+    , const impl::GeometryRange&      range) noexcept
 {
-    glDrawArrays(GL_TRIANGLES, 0, vertex_buffer_.elem_count_);
+    return Ptr<DrawCommand>{ new DrawCommand{
+          dynamic_cast<const Pipeline&>(pipeline)
+        , dynamic_cast<const GeometryPoolHandle&>(geometry)
+        , range
+    } };
+}
+
+DLL_EXPORT void DrawCommand::operator()(impl::CommandQueue& queue)
+{
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    if (q.changeState(q.bound_program_, pipeline_.program_, &impl::FrameStats::pipeline_binds)) {
+        q.flushDraws();
+        glUseProgram(pipeline_.program_);
+    }
+    if (q.changeState(q.bound_geometry_, &geometry_, &impl::FrameStats::buffer_binds)) {
+        q.flushDraws();
+        geometry_.bind();
+    }
+    q.pushDraw(range_, draw_data_);
 }
 
-DrawCommand::DrawCommand(const BufferHandle& vertex_buffer) noexcept
-    : vertex_buffer_{ vertex_buffer }
+DrawCommand::DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry, const impl::GeometryRange& range) noexcept
+    : impl::DrawCommand{ pipeline, geometry }
+    , pipeline_{ pipeline }
+    , geometry_{ geometry }
+    , range_{ range }
 {}
 
 } // namespace opengl
\ No newline at end of file
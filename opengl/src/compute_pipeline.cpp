@@ -0,0 +1,64 @@
+#include <glad/glad.h>
+
+#include "opengl/compute_pipeline.hpp"
+
+namespace opengl {
+
+DLL_EXPORT Ptr<ComputePipeline> ComputePipeline::create() noexcept
+{
+    return Ptr<ComputePipeline>{ new ComputePipeline{} };
+}
+
+DLL_EXPORT ComputePipeline::~ComputePipeline()
+{
+    glDeleteProgram(program_);
+}
+
+DLL_EXPORT void ComputePipeline::setShader(const impl::GlslShader& shader, const impl::SpecializationConstants&)
+{
+    // GLSL sources can't be specialized, the constants keep their defaults
+    shader_ = &dynamic_cast<const GlslShader&>(shader);
+}
+
+DLL_EXPORT void ComputePipeline::addStorageBuffer(uint32_t binding, const impl::BufferHandle& buffer)
+{
+    storage_buffers_.emplace_back(binding, dynamic_cast<const BufferHandle&>(buffer).buffer_);
+}
+
+DLL_EXPORT bool ComputePipeline::use()
+{
+    if (!shader_ || shader_->type_ != GL_COMPUTE_SHADER) {
+        return util::handle_error() << "Compute pipeline needs a compute shader";
+    }
+    shader_->compile();
+    if (!shader_->checkCompileStatus()) {
+        return util::handle_error();
+    }
+    glAttachShader(program_, shader_->shader_);
+    glLinkProgram(program_);
+    glDetachShader(program_, shader_->shader_);
+
+    GLint result = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &result);
+    if (!result) {
+        int info_log_length = 0;
+        glGetProgramiv(program_, GL_INFO_LOG_LENGTH, &info_log_length);
+        std::string err_msg(std::max(info_log_length, 1), '\0');
+        glGetProgramInfoLog(program_, info_log_length, nullptr, &err_msg[0]);
+        return util::handle_error() << err_msg;
+    }
+    return true;
+}
+
+ComputePipeline::ComputePipeline() noexcept
+    : program_{ glCreateProgram() }
+{}
+
+void ComputePipeline::bindStorageBuffers() const
+{
+    for (const auto& [binding, buffer] : storage_buffers_) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer);
+    }
+}
+
+} // namespace opengl
@@ -0,0 +1,145 @@
+// OPENGL_EGL is defined by building with /p:OpenGLEgl=true, which also links libEGL
+#ifdef OPENGL_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif // OPENGL_EGL
+
+#include "opengl/egl_context.hpp"
+
+namespace opengl {
+namespace details {
+
+#ifdef OPENGL_EGL
+
+namespace {
+
+constexpr EGLint ConfigAttributes[] = {
+      EGL_SURFACE_TYPE   , EGL_PBUFFER_BIT
+    , EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT
+    , EGL_RED_SIZE       , 8
+    , EGL_GREEN_SIZE     , 8
+    , EGL_BLUE_SIZE      , 8
+    , EGL_ALPHA_SIZE     , 8
+    , EGL_NONE
+};
+
+constexpr EGLint ContextAttributes[] = {
+      EGL_CONTEXT_MAJOR_VERSION      , 4
+    , EGL_CONTEXT_MINOR_VERSION      , 6
+    , EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT
+    , EGL_NONE
+};
+
+Opt<EGLDisplay> getDisplay()
+{
+    // the surfaceless platform needs neither a display server nor a render node picked by hand
+    const char* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (!client_extensions) {
+        return util::handle_error() << "EGL client extensions are not supported: " << eglGetError();
+    }
+    if (std::string_view{ client_extensions }.contains("EGL_MESA_platform_surfaceless")) {
+        const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (get_platform_display) {
+            if (const auto display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr); display != EGL_NO_DISPLAY) {
+                return display;
+            }
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+} // namespace
+
+Ptr<EglContext> EglContext::create(uint32_t width, uint32_t height) noexcept
+{
+    auto context = Ptr<EglContext>{ new EglContext{} };
+
+    const auto found = getDisplay();
+    if (!found) {
+        return util::handle_error();
+    }
+    const auto display = *found;
+    if (display == EGL_NO_DISPLAY) {
+        return util::handle_error() << "No EGL display";
+    }
+    EGLint major = 0, minor = 0;
+    if (!eglInitialize(display, &major, &minor)) {
+        return util::handle_error() << "eglInitialize failed: " << eglGetError();
+    }
+    context->display_ = display;
+    std::cout << "EGL version: " << major << '.' << minor << '\n';
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        return util::handle_error() << "Desktop OpenGL is not supported by EGL";
+    }
+    EGLConfig config = nullptr;
+    EGLint config_count = 0;
+    if (!eglChooseConfig(display, ConfigAttributes, &config, 1, &config_count) || config_count == 0) {
+        return util::handle_error() << "No EGL config for an OpenGL pbuffer";
+    }
+    context->context_ = eglCreateContext(display, config, EGL_NO_CONTEXT, ContextAttributes);
+    if (context->context_ == EGL_NO_CONTEXT) {
+        return util::handle_error() << "eglCreateContext failed: " << eglGetError();
+    }
+
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!extensions) {
+        return util::handle_error() << "eglQueryString failed: " << eglGetError();
+    }
+    if (!std::string_view{ extensions }.contains("EGL_KHR_surfaceless_context")) {
+        const EGLint pbuffer_attributes[] = {
+              EGL_WIDTH , static_cast<EGLint>(width)
+            , EGL_HEIGHT, static_cast<EGLint>(height)
+            , EGL_NONE
+        };
+        context->surface_ = eglCreatePbufferSurface(display, config, pbuffer_attributes);
+        if (context->surface_ == EGL_NO_SURFACE) {
+            return util::handle_error() << "eglCreatePbufferSurface failed: " << eglGetError();
+        }
+    }
+    if (!eglMakeCurrent(display, context->surface_, context->surface_, context->context_)) {
+        return util::handle_error() << "eglMakeCurrent failed: " << eglGetError();
+    }
+    return context;
+}
+
+EglContext::~EglContext()
+{
+    if (!display_) {
+        return;
+    }
+    eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface_) {
+        eglDestroySurface(display_, surface_);
+    }
+    if (context_) {
+        eglDestroyContext(display_, context_);
+    }
+    eglTerminate(display_);
+}
+
+void* EglContext::getProcAddress(const char* name)
+{
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+#else
+
+Ptr<EglContext> EglContext::create(uint32_t, uint32_t) noexcept
+{
+    return util::handle_error() << "Headless OpenGL needs EGL, build with /p:OpenGLEgl=true";
+}
+
+EglContext::~EglContext() = default;
+
+void* EglContext::getProcAddress(const char*)
+{
+    return nullptr;
+}
+
+#endif // OPENGL_EGL
+
+EglContext::EglContext() noexcept = default;
+
+} // namespace details
+} // namespace opengl
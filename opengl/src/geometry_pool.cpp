@@ -0,0 +1,64 @@
+#include <glad/glad.h>
+
+#include "model.hpp"
+
+#include "opengl/geometry_pool.hpp"
+
+namespace opengl {
+
+DLL_EXPORT GeometryPoolHandle::~GeometryPoolHandle()
+{
+    glDeleteBuffers(1, &index_buffer_);
+    glDeleteBuffers(1, &vertex_buffer_);
+}
+
+GeometryPoolHandle::GeometryPoolHandle() noexcept
+{
+    glCreateBuffers(1, &vertex_buffer_);
+    glCreateBuffers(1, &index_buffer_);
+    // vertex attributes set up afterwards are sourced from the bound array buffer
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+}
+
+bool GeometryPoolHandle::write(GLuint buffer, size_t& capacity, const void* data, size_t offset, size_t size)
+{
+    const auto required = offset + size;
+    if (capacity < required) {
+        // mutable storage keeps the buffer name, so the vertex array does not have to be set up again
+        capacity = grownCapacity(capacity, required);
+        glNamedBufferData(buffer, capacity, nullptr, GL_STATIC_DRAW);
+        offset = 0;
+    }
+    glNamedBufferSubData(buffer, offset, required - offset, static_cast<const char*>(data) + offset);
+    return true;
+}
+
+void GeometryPoolHandle::bind() const
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+}
+
+template<typename V>
+DLL_EXPORT Ptr<GeometryPool<V>> GeometryPool<V>::create() noexcept
+{
+    return Ptr<GeometryPool>{ new GeometryPool{} };
+}
+
+template<typename V>
+bool GeometryPool<V>::upload(size_t first_vertex, size_t first_index)
+{
+    const auto& vertices = impl::GeometryPool<V>::vertices_;
+    const auto& indices = impl::GeometryPool<V>::indices_;
+    if (!write(vertex_buffer_, vertex_capacity_, vertices.data(), first_vertex * sizeof(V), (vertices.size() - first_vertex) * sizeof(V))) {
+        return util::handle_error();
+    }
+    if (!write(index_buffer_, index_capacity_, indices.data(), first_index * sizeof(uint32_t), (indices.size() - first_index) * sizeof(uint32_t))) {
+        return util::handle_error();
+    }
+    device_memory_.resize(vertex_capacity_ + index_capacity_);
+    return true;
+}
+
+template class GeometryPool<Vertex>;
+
+} // namespace opengl
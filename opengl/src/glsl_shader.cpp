@@ -1,5 +1,7 @@
 #include <glad/glad.h>
 
+#include "trace.hpp"
+
 #include "opengl/glsl_shader.hpp"
 
 namespace opengl {
@@ -7,28 +9,49 @@ namespace opengl {
 DLL_EXPORT Ptr<GlslShader> GlslShader::create(ShaderType type, std::string_view path) noexcept
 {
     auto shader = Ptr<GlslShader>{ new GlslShader{ util::to_underlying(type), path } };
-    GLint result = GL_FALSE;
-    glGetShaderiv(shader->shader_, GL_COMPILE_STATUS, &result);
-    if (!result) {
-        int info_log_length = 0;
-        glGetShaderiv(shader->shader_, GL_INFO_LOG_LENGTH, &info_log_length);
-        if (info_log_length > 0) {
-            std::string err_msg(info_log_length + 1, '\0');
-            glGetShaderInfoLog(shader->shader_, info_log_length, nullptr, &err_msg[0]);
-            return util::handle_error() << err_msg;
-        }
+    if (shader->source_.empty()) {
+        return util::handle_error() << "Failed to read " << path;
     }
     return shader;
 }
 
+DLL_EXPORT GlslShader::~GlslShader()
+{
+    if (shader_) {
+        glDeleteShader(shader_);
+    }
+}
+
 GlslShader::GlslShader(GLenum type, std::string_view path) noexcept
     : type_{ type }
-    , shader_{ glCreateShader(type) }
+    , source_{ util::read_file_contents(path) }
+    , source_memory_{ MemoryStats::Heap::Host, MemoryStats::Category::ShaderCode, source_.size() }
+{}
+
+void GlslShader::compile() const
 {
-    const auto shader_code = util::read_file_contents(path);
-    const auto* code_ptr = shader_code.c_str();
+    TRACE_ZONE("GlslShader::compile");
+    if (shader_) {
+        return;
+    }
+    shader_ = glCreateShader(type_);
+    const auto* code_ptr = source_.c_str();
     glShaderSource(shader_, 1, &code_ptr, nullptr);
     glCompileShader(shader_);
 }
 
-} // namespace opengl
\ No newline at end of file
+bool GlslShader::checkCompileStatus() const
+{
+    GLint result = GL_FALSE;
+    glGetShaderiv(shader_, GL_COMPILE_STATUS, &result);
+    if (!result) {
+        int info_log_length = 0;
+        glGetShaderiv(shader_, GL_INFO_LOG_LENGTH, &info_log_length);
+        std::string err_msg(std::max(info_log_length, 1), '\0');
+        glGetShaderInfoLog(shader_, info_log_length, nullptr, &err_msg[0]);
+        return util::handle_error() << err_msg;
+    }
+    return true;
+}
+
+} // namespace opengl
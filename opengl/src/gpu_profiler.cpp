@@ -0,0 +1,106 @@
+#include <algorithm>
+
+#include <glad/glad.h>
+
+#include "opengl/gpu_profiler.hpp"
+
+namespace opengl {
+namespace details {
+
+Ptr<GpuProfiler> GpuProfiler::create(bool statistics) noexcept
+{
+    Ptr<GpuProfiler> profiler{ new GpuProfiler{ statistics } };
+    for (auto& [timestamps, stats, recorded] : profiler->frames_) {
+        glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(timestamps.size()), timestamps.data());
+        if (statistics) {
+            for (size_t i = 0; i != StatisticTargets.size(); ++i) {
+                glCreateQueries(StatisticTargets[i], 1, &stats[i]);
+            }
+        }
+    }
+    return profiler;
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    for (auto& [timestamps, stats, recorded] : frames_) {
+        glDeleteQueries(static_cast<GLsizei>(timestamps.size()), timestamps.data());
+        if (statistics_) {
+            glDeleteQueries(static_cast<GLsizei>(stats.size()), stats.data());
+        }
+    }
+}
+
+void GpuProfiler::begin()
+{
+    auto& queries = frames_[current_frame_];
+    if (queries.recorded) {
+        collect(queries);
+    }
+    glQueryCounter(queries.timestamps[0], GL_TIMESTAMP);
+    if (statistics_) {
+        for (size_t i = 0; i != StatisticTargets.size(); ++i) {
+            glBeginQuery(StatisticTargets[i], queries.statistics[i]);
+        }
+    }
+    queries.recorded = true;
+}
+
+void GpuProfiler::end()
+{
+    auto& queries = frames_[current_frame_];
+    if (statistics_) {
+        for (const auto target : StatisticTargets) {
+            glEndQuery(target);
+        }
+    }
+    glQueryCounter(queries.timestamps[1], GL_TIMESTAMP);
+    current_frame_ = (current_frame_ + 1) % FrameCount;
+}
+
+void GpuProfiler::collect(Queries& queries)
+{
+    // skipped rather than waited for when the GPU is further behind than the ring is long
+    if (!available(queries.timestamps[1])) {
+        return;
+    }
+    if (statistics_ && !std::ranges::all_of(queries.statistics, available)) {
+        return;
+    }
+
+    impl::GpuFrameStats stats{};
+    std::array<GLuint64, 2> timestamps{};
+    glGetQueryObjectui64v(queries.timestamps[0], GL_QUERY_RESULT, &timestamps[0]);
+    glGetQueryObjectui64v(queries.timestamps[1], GL_QUERY_RESULT, &timestamps[1]);
+    // there are no render passes, every command of the frame is one
+    stats.passes.push_back({ "frame", (timestamps[1] - timestamps[0]) / 1000.0 });
+
+    if (statistics_) {
+        std::array<GLuint64, StatisticTargets.size()> results{};
+        for (size_t i = 0; i != results.size(); ++i) {
+            glGetQueryObjectui64v(queries.statistics[i], GL_QUERY_RESULT, &results[i]);
+        }
+        stats.input_primitives           = results[0];
+        stats.vertex_invocations         = results[1];
+        stats.clipping_input_primitives  = results[2];
+        stats.clipping_output_primitives = results[3];
+        stats.fragment_invocations       = results[4];
+    }
+
+    latest_ = std::move(stats);
+    ++completed_frames_;
+}
+
+bool GpuProfiler::available(GLuint query)
+{
+    GLuint result = GL_FALSE;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &result);
+    return result == GL_TRUE;
+}
+
+GpuProfiler::GpuProfiler(bool statistics) noexcept
+    : statistics_{ statistics }
+{}
+
+} // namespace details
+} // namespace opengl
@@ -1,3 +1,5 @@
+#include <iomanip>
+
 #include <glad/glad.h>
 
 #include "opengl/pipeline.hpp"
@@ -6,24 +8,67 @@ namespace opengl {
 
 DLL_EXPORT Ptr<Pipeline> Pipeline::create() noexcept
 {
-    return Ptr<Pipeline>{ new Pipeline{} };
+    auto pipeline = Ptr<Pipeline>{ new Pipeline{} };
+    GLint binary_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binary_formats);
+    const auto cache_dir = Config::instance().get<std::string>("shader_cache");
+    if (cache_dir && binary_formats > 0) {
+        std::error_code ec{};
+        std::filesystem::create_directories(*cache_dir, ec);
+        if (!ec) {
+            pipeline->cache_dir_ = *cache_dir;
+        }
+    }
+    return pipeline;
 }
 
-DLL_EXPORT void Pipeline::addShader(const impl::GlslShader& shader)
+DLL_EXPORT void Pipeline::addShader(const impl::GlslShader& shader, const impl::SpecializationConstants&)
 {
+    // GLSL sources can't be specialized, the constants keep their defaults
     shaders_.push_back(&shader);
 }
 
 DLL_EXPORT bool Pipeline::use(const impl::VertexDescription& description)
+{
+    const auto binary_path = getProgramBinaryPath();
+    const auto loaded = !binary_path.empty() && loadProgramBinary(binary_path);
+    if (!loaded) {
+        if (!link()) {
+            return util::handle_error();
+        }
+        if (!binary_path.empty() && !storeProgramBinary(binary_path)) {
+            IGNORE(util::handle_error() << "Failed to cache " << binary_path);
+        }
+    }
+    if (!binary_path.empty()) {
+        std::cout << "Program binary cache " << (loaded ? "hit" : "miss") << ": " << binary_path << "\n";
+    }
+
+    glUseProgram(program_);
+    glEnable(GL_DEPTH_TEST);
+    return true;
+}
+
+Pipeline::Pipeline() noexcept
+    : program_{ glCreateProgram() }
+{}
+
+bool Pipeline::link()
 {
     for (const auto& shader : shaders_) {
-        glAttachShader(program_, dynamic_cast<const GlslShader*>(shader)->shader_);
+        dynamic_cast<const GlslShader*>(shader)->compile();
     }
+    for (const auto& shader : shaders_) {
+        const auto& shad = *dynamic_cast<const GlslShader*>(shader);
+        if (!shad.checkCompileStatus()) {
+            return util::handle_error();
+        }
+        glAttachShader(program_, shad.shader_);
+    }
+    glProgramParameteri(program_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(program_);
     for (const auto& shader : shaders_) {
-        const auto& shad = dynamic_cast<const GlslShader*>(shader)->shader_;
-        glDetachShader(program_, shad);
-        glDeleteShader(shad);
+        glDetachShader(program_, dynamic_cast<const GlslShader*>(shader)->shader_);
     }
 
     GLint result = GL_FALSE;
@@ -31,20 +76,64 @@ DLL_EXPORT bool Pipeline::use(const impl::VertexDescription& description)
     if (!result) {
         int info_log_length = 0;
         glGetProgramiv(program_, GL_INFO_LOG_LENGTH, &info_log_length);
-        if (info_log_length > 0) {
-            std::string err_msg(info_log_length + 1, '\0');
-            glGetProgramInfoLog(program_, info_log_length, nullptr, &err_msg[0]);
-            return util::handle_error() << err_msg;
-        }
+        std::string err_msg(std::max(info_log_length, 1), '\0');
+        glGetProgramInfoLog(program_, info_log_length, nullptr, &err_msg[0]);
+        return util::handle_error() << err_msg;
     }
-    glUseProgram(program_);
-    glEnable(GL_DEPTH_TEST);
     return true;
 }
 
-Pipeline::Pipeline() noexcept
-    : program_{ glCreateProgram() }
-{}
+std::filesystem::path Pipeline::getProgramBinaryPath() const
+{
+    if (cache_dir_.empty()) {
+        return {};
+    }
+
+    // a driver update may change the binary format or reject old binaries, so it gets a new entry
+    uint64_t hash = util::fnv1a(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hash = util::fnv1a(reinterpret_cast<const char*>(glGetString(GL_RENDERER)), hash);
+    hash = util::fnv1a(reinterpret_cast<const char*>(glGetString(GL_VERSION)), hash);
+    for (const auto& shader : shaders_) {
+        const auto& shad = *dynamic_cast<const GlslShader*>(shader);
+        hash = util::fnv1a({ reinterpret_cast<const char*>(&shad.type_), sizeof(shad.type_) }, hash);
+        hash = util::fnv1a(shad.source_, hash);
+    }
+
+    std::stringstream name{};
+    name << std::hex << std::setw(16) << std::setfill('0') << hash << ".glbin";
+    return cache_dir_ / name.str();
+}
+
+bool Pipeline::loadProgramBinary(const std::filesystem::path& path)
+{
+    // | binary format : GLenum | program binary |
+    const auto data = util::read_binary_file<char>(path);
+    if (!data || data->size() <= sizeof(GLenum)) {
+        return false;
+    }
+    GLenum format = 0;
+    std::memcpy(&format, data->data(), sizeof(format));
+    glProgramBinary(program_, format, data->data() + sizeof(format), static_cast<GLsizei>(data->size() - sizeof(format)));
+
+    // drivers are free to reject a binary at any time, the program is then linked from source
+    GLint result = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &result);
+    return result == GL_TRUE;
+}
+
+bool Pipeline::storeProgramBinary(const std::filesystem::path& path) const
+{
+    GLint length = 0;
+    glGetProgramiv(program_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return util::handle_error();
+    }
+    std::vector<char> data(sizeof(GLenum) + length);
+    GLenum format = 0;
+    glGetProgramBinary(program_, length, nullptr, &format, data.data() + sizeof(format));
+    std::memcpy(data.data(), &format, sizeof(format));
+    return util::write_binary_file(path, data.data(), data.size());
+}
 
 constexpr GLbitfield Pipeline::GetShaderTypeBit(GLenum bit)
 {
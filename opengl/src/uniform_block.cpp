@@ -2,6 +2,7 @@
 
 #include "constants.h"
 #include "model.hpp"
+#include "trace.hpp"
 
 #include "opengl/uniform_block.hpp"
 
@@ -18,7 +19,19 @@ DLL_EXPORT Ptr<UniformBlock<UBO>> UniformBlock<UBO>::create(impl::GlslShader&, c
 template<typename UBO>
 DLL_EXPORT void UniformBlock<UBO>::update()
 {
-    glNamedBufferData(buffer_, sizeof(UBO), &ubo_, GL_DYNAMIC_DRAW);
+    TRACE_ZONE("UniformBlock::update");
+    if (!initialized_) {
+        glNamedBufferData(buffer_, sizeof(UBO), &ubo_, GL_DYNAMIC_DRAW);
+        device_memory_ = { MemoryStats::Heap::Device, MemoryStats::Category::Uniforms, sizeof(UBO) };
+        uploaded_ = ubo_;
+        initialized_ = true;
+        impl::UniformBlock<UBO>::uploaded_bytes_ = sizeof(UBO);
+        return;
+    }
+    // frames end with glFinish, so the buffer isn't in use and can be written in place
+    impl::UniformBlock<UBO>::uploaded_bytes_ = util::copy_changed_ranges(ubo_, uploaded_, [this](size_t offset, size_t size) {
+        glNamedBufferSubData(buffer_, offset, size, reinterpret_cast<const char*>(&ubo_) + offset);
+    });
 }
 
 template<typename UBO>
@@ -1,6 +1,10 @@
+#include <chrono>
+
 #include <glad/glad.h>
 #include <glfw/glfw3.h>
 
+#include "trace.hpp"
+
 #include "opengl/command_queue.hpp"
 #include "opengl/window.hpp"
 
@@ -18,26 +22,90 @@ constexpr impl::Window::HintsList Hints = {
 
 DLL_EXPORT Ptr<Window> Window::create(uint32_t width, uint32_t height, std::string_view title) noexcept
 {
-    auto window = Ptr<Window>{ new Window{width, height, title} };
-    if (!window.get()) {
+    const auto headless = Config::instance().get<bool>("headless").value_or(false);
+    auto window = Ptr<Window>{ new Window{width, height, title, headless} };
+    if (headless) {
+        window->egl_context_ = details::EglContext::create(width, height);
+        if (!window->egl_context_) {
+            return util::handle_error();
+        }
+        return window;
+    }
+    if (!window->window_) {
         return util::handle_error() << getGlfwErrorDescription();
     }
     glfwMakeContextCurrent(window->window_.get());
     return window;
 }
 
+DLL_EXPORT Window::~Window()
+{
+    // the context goes away after this, with the EGL one when headless
+    gpu_profiler_.reset();
+    if (framebuffer_) {
+        glDeleteFramebuffers(1, &framebuffer_);
+        glDeleteRenderbuffers(1, &color_renderbuffer_);
+        glDeleteRenderbuffers(1, &depth_renderbuffer_);
+    }
+}
+
 DLL_EXPORT void Window::swapFramebuffers(impl::CommandQueue& queue)
 {
+    TRACE_ZONE("Window::swapFramebuffers");
     auto& q = dynamic_cast<CommandQueue&>(queue);
+    q.bound_program_ = 0;
+    q.bound_geometry_ = nullptr;
+    q.cleared_ = false;
+    q.sortCommands(q.commands_);
+    if (!q.reserveDraws(q.commands_.size())) {
+        return;
+    }
+    if (gpu_profiler_) {
+        gpu_profiler_->begin();
+    }
+    // draws are gathered into multi-draws, the ones pending have to be issued before any other command
     for (const auto& command : q.commands_) {
+        if (!command->sortKey()) {
+            q.flushDraws();
+        }
         (*command)(q);
     }
+    q.flushDraws();
+    if (gpu_profiler_) {
+        gpu_profiler_->end();
+    }
+    const auto wait_start = std::chrono::steady_clock::now();
     glFinish();
-    glfwSwapBuffers(window_.get());
+    q.frame_stats_.fence_wait_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - wait_start).count();
+    if (!headless_) {
+        glfwSwapBuffers(window_.get());
+    }
 }
 
-Window::Window(uint32_t width, uint32_t height, std::string_view title) noexcept
-    : impl::Window{ width, height, title, Hints }
+Window::Window(uint32_t width, uint32_t height, std::string_view title, bool headless) noexcept
+    : impl::Window{ width, height, title, Hints, headless }
 {}
 
+bool Window::createOffscreenFramebuffer()
+{
+    glCreateRenderbuffers(1, &color_renderbuffer_);
+    glNamedRenderbufferStorage(color_renderbuffer_, GL_RGBA8, width_, height_);
+    glCreateRenderbuffers(1, &depth_renderbuffer_);
+    glNamedRenderbufferStorage(depth_renderbuffer_, GL_DEPTH_COMPONENT32F, width_, height_);
+    // what the formats need, the driver may pad it
+    renderbuffer_memory_ = { MemoryStats::Heap::Device, MemoryStats::Category::Images, static_cast<size_t>(width_) * height_ * (4 + 4) };
+
+    glCreateFramebuffers(1, &framebuffer_);
+    glNamedFramebufferRenderbuffer(framebuffer_, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_renderbuffer_);
+    glNamedFramebufferRenderbuffer(framebuffer_, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_renderbuffer_);
+    if (const auto status = glCheckNamedFramebufferStatus(framebuffer_, GL_FRAMEBUFFER); status != GL_FRAMEBUFFER_COMPLETE) {
+        return util::handle_error() << "Offscreen framebuffer is incomplete: " << status;
+    }
+    // stays bound, clears and draws go here instead of the default framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    // a surfaceless context starts with an empty viewport
+    glViewport(0, 0, width_, height_);
+    return true;
+}
+
 } // namespace opengl
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "config.hpp"
 #include "framework.hpp"
 
+#include "cpu/renderer.hpp"
+#include "null/renderer.hpp"
 #include "opengl/renderer.hpp"
 #include "vulkan/renderer.hpp"
 
@@ -21,6 +23,12 @@ public:
         else if (backend == "vulkan") {
             return vulkan::Renderer::create();
         }
+        else if (backend == "cpu") {
+            return cpu::Renderer::create();
+        }
+        else if (backend == "null") {
+            return null::Renderer::create();
+        }
         return util::handle_error() << "unknown backend " << backend << "specified";
     }
 };
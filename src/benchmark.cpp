@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+#include "benchmark.hpp"
+#include "config.hpp"
+
+namespace {
+
+constexpr std::array StatNames{ "mean_us", "stddev_us", "min_us", "max_us", "p50_us", "p90_us", "p99_us", "p999_us" };
+
+std::array<double, StatNames.size()> statValues(const Benchmark::Stats& stats)
+{
+    return { stats.mean, stats.stddev, stats.min, stats.max, stats.p50, stats.p90, stats.p99, stats.p999 };
+}
+
+// nearest-rank percentile of sorted samples
+template <typename T>
+T nearestRank(const std::vector<T>& sorted, double p)
+{
+    const auto rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+// reads back what Benchmark::write produced, either format
+std::optional<double> readBaselineValue(const std::string& baseline, bool csv, std::string_view name)
+{
+    try {
+        if (csv) {
+            std::istringstream lines{ baseline };
+            std::string header, row;
+            std::getline(lines, header);
+            std::getline(lines, row);
+            std::istringstream columns{ header }, values{ row };
+            for (std::string column, value; std::getline(columns, column, ',') && std::getline(values, value, ',');) {
+                if (column == name) {
+                    return std::stod(value);
+                }
+            }
+            return std::nullopt;
+        }
+        const auto key = baseline.find("\"" + std::string{ name } + "\":");
+        if (key == std::string::npos) {
+            return std::nullopt;
+        }
+        return std::stod(baseline.substr(key + name.size() + 3));
+    }
+    catch (...) {
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+DLL_EXPORT Benchmark::Benchmark()
+{
+    const auto& config = Config::instance();
+    warmup_frames_ = config.get<size_t>("bench_warmup_frames").value_or(100);
+    measured_frames_ = std::max<size_t>(config.get<size_t>("bench_frames").value_or(10000), 1);
+    duration_ = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>{ config.get<double>("bench_duration").value_or(0.0) });
+    output_ = config.get<std::string>("bench_output").value_or("");
+    baseline_ = config.get<std::string>("bench_baseline").value_or("");
+    threshold_ = config.get<double>("bench_threshold").value_or(5.0);
+    frame_times_.reserve(duration_.count() ? 0 : measured_frames_);
+    measure_start_ = std::chrono::steady_clock::now();
+}
+
+DLL_EXPORT bool Benchmark::done(std::chrono::steady_clock::time_point now) const
+{
+    if (warmingUp()) {
+        return false;
+    }
+    if (duration_.count()) {
+        return !frame_times_.empty() && now - measure_start_ >= duration_;
+    }
+    return frame_times_.size() >= measured_frames_;
+}
+
+DLL_EXPORT void Benchmark::addFrame(std::chrono::nanoseconds frame_time, std::chrono::steady_clock::time_point now)
+{
+    if (warmingUp()) {
+        if (++frame_ == warmup_frames_) {
+            measure_start_ = now;
+        }
+        return;
+    }
+    ++frame_;
+    frame_times_.push_back(frame_time.count());
+}
+
+DLL_EXPORT void Benchmark::addSample(std::string_view series, double value)
+{
+    if (warmingUp()) {
+        return;
+    }
+    auto it = samples_.find(series);
+    if (it == samples_.end()) {
+        it = samples_.emplace(std::string{ series }, std::vector<double>{}).first;
+    }
+    it->second.push_back(value);
+}
+
+DLL_EXPORT void Benchmark::setMetadata(std::string_view key, std::string value)
+{
+    metadata_[std::string{ key }] = std::move(value);
+}
+
+DLL_EXPORT Benchmark::Stats Benchmark::stats() const
+{
+    Stats stats{};
+    stats.frames = frame_times_.size();
+    stats.histogram.resize(HistogramBuckets);
+    for (const auto& [name, samples] : samples_) {
+        auto sorted = samples;
+        std::ranges::sort(sorted);
+        stats.series[name] = {
+              std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size()
+            , nearestRank(sorted, 0.5)
+            , nearestRank(sorted, 0.99)
+        };
+    }
+    if (frame_times_.empty()) {
+        return stats;
+    }
+
+    auto sorted = frame_times_;
+    std::ranges::sort(sorted);
+    const auto us = [](uint64_t ns) { return ns / 1000.0; };
+    // nearest rank, so p99.9 of fewer than 1000 frames is the max
+    const auto percentile = [&](double p) { return us(nearestRank(sorted, p)); };
+
+    stats.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size() / 1000.0;
+    const auto variance = std::accumulate(sorted.begin(), sorted.end(), 0.0, [&](double sum, uint64_t ns) {
+        return sum + (us(ns) - stats.mean) * (us(ns) - stats.mean);
+    }) / sorted.size();
+    stats.stddev = std::sqrt(variance);
+    stats.min = us(sorted.front());
+    stats.max = us(sorted.back());
+    stats.p50 = percentile(0.5);
+    stats.p90 = percentile(0.9);
+    stats.p99 = percentile(0.99);
+    stats.p999 = percentile(0.999);
+
+    const auto bucket_width = (sorted.back() - sorted.front()) / static_cast<double>(HistogramBuckets);
+    for (const auto ns : sorted) {
+        const auto bucket = bucket_width > 0.0 ? static_cast<size_t>((ns - sorted.front()) / bucket_width) : 0;
+        ++stats.histogram[std::min(bucket, HistogramBuckets - 1)];
+    }
+    return stats;
+}
+
+DLL_EXPORT void Benchmark::print(std::ostream& out, const Stats& stats) const
+{
+    out << "Frames: " << stats.frames << " after " << warmup_frames_ << " warmup frames\n";
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    out << "Average: " << stats.mean << "us, stddev: " << stats.stddev << "us\n";
+    out << "Min: " << stats.min << "us, max: " << stats.max << "us\n";
+    out << "p50: " << stats.p50 << "us, p90: " << stats.p90 << "us, p99: " << stats.p99 << "us, p99.9: " << stats.p999 << "us\n";
+
+    const auto bucket_width = (stats.max - stats.min) / HistogramBuckets;
+    const auto highest = std::max<size_t>(*std::ranges::max_element(stats.histogram), 1);
+    for (size_t i = 0; i != stats.histogram.size(); ++i) {
+        out << std::setw(10) << stats.min + i * bucket_width << "us | "
+            << std::string(stats.histogram[i] * 50 / highest, '#') << " " << stats.histogram[i] << "\n";
+    }
+    for (const auto& [name, series] : stats.series) {
+        out << name << ": average " << series.mean << ", p50 " << series.p50 << ", p99 " << series.p99 << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+DLL_EXPORT bool Benchmark::write(const Stats& stats) const
+{
+    if (output_.empty()) {
+        return true;
+    }
+    std::ofstream out{ output_ };
+    if (!out) {
+        return util::handle_error() << "cannot open " << output_;
+    }
+    if (std::filesystem::path{ output_ }.extension() == ".csv") {
+        writeCsv(out, stats);
+    }
+    else {
+        writeJson(out, stats);
+    }
+    std::cout << "Benchmark results written to " << output_ << "\n";
+    return true;
+}
+
+void Benchmark::writeJson(std::ostream& out, const Stats& stats) const
+{
+    out << "{\n  \"metadata\": {";
+    for (auto it = metadata_.begin(); it != metadata_.end(); ++it) {
+        out << (it == metadata_.begin() ? "\n" : ",\n") << "    \"" << util::json_escape(it->first) << "\": \"" << util::json_escape(it->second) << "\"";
+    }
+    out << "\n  },\n";
+    out << "  \"warmup_frames\": " << warmup_frames_ << ",\n";
+    out << "  \"frames\": " << stats.frames << ",\n";
+    const auto values = statValues(stats);
+    for (size_t i = 0; i != StatNames.size(); ++i) {
+        out << "  \"" << StatNames[i] << "\": " << values[i] << ",\n";
+    }
+    for (const auto& [name, series] : stats.series) {
+        const auto key = util::json_escape(name);
+        out << "  \"" << key << "_mean\": " << series.mean << ",\n";
+        out << "  \"" << key << "_p50\": " << series.p50 << ",\n";
+        out << "  \"" << key << "_p99\": " << series.p99 << ",\n";
+    }
+    out << "  \"histogram\": { \"min_us\": " << stats.min << ", \"bucket_us\": " << (stats.max - stats.min) / HistogramBuckets << ", \"counts\": [";
+    for (size_t i = 0; i != stats.histogram.size(); ++i) {
+        out << (i ? ", " : "") << stats.histogram[i];
+    }
+    out << "] }\n}\n";
+}
+
+void Benchmark::writeCsv(std::ostream& out, const Stats& stats) const
+{
+    // one header and one row, so runs can be concatenated without the header
+    for (const auto& [key, value] : metadata_) {
+        out << key << ",";
+    }
+    out << "warmup_frames,frames";
+    for (const auto name : StatNames) {
+        out << "," << name;
+    }
+    for (const auto& [name, series] : stats.series) {
+        out << "," << name << "_mean," << name << "_p50," << name << "_p99";
+    }
+    out << "\n";
+    for (const auto& [key, value] : metadata_) {
+        auto cell = value;
+        std::ranges::replace(cell, ',', ';');
+        out << cell << ",";
+    }
+    out << warmup_frames_ << "," << stats.frames;
+    for (const auto value : statValues(stats)) {
+        out << "," << value;
+    }
+    for (const auto& [name, series] : stats.series) {
+        out << "," << series.mean << "," << series.p50 << "," << series.p99;
+    }
+    out << "\n";
+}
+
+DLL_EXPORT bool Benchmark::compareToBaseline(std::ostream& out, const Stats& stats) const
+{
+    if (baseline_.empty()) {
+        return true;
+    }
+    const auto baseline = util::read_file_contents(baseline_.c_str());
+    if (baseline.empty()) {
+        return util::handle_error() << "cannot read baseline " << baseline_;
+    }
+    const auto csv = std::filesystem::path{ baseline_ }.extension() == ".csv";
+
+    bool regressed = false;
+    const auto values = statValues(stats);
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    out << "Compared to " << baseline_ << " (threshold " << threshold_ << "%):\n";
+    for (size_t i = 0; i != StatNames.size(); ++i) {
+        const std::string_view name = StatNames[i];
+        // min and stddev getting worse are not regressions on their own
+        if (name == "min_us" || name == "stddev_us") {
+            continue;
+        }
+        const auto base = readBaselineValue(baseline, csv, name);
+        if (!base || *base <= 0.0) {
+            continue;
+        }
+        const auto change = (values[i] - *base) / *base * 100.0;
+        const auto worse = change > threshold_;
+        regressed |= worse;
+        out << "  " << name << ": " << *base << " -> " << values[i] << " (" << std::showpos << change << std::noshowpos << "%)"
+            << (worse ? " REGRESSION" : "") << "\n";
+    }
+    // counts such as shader invocations follow the scene, only times can regress
+    for (const auto& [series_name, series] : stats.series) {
+        if (!series_name.ends_with("_us")) {
+            continue;
+        }
+        for (const auto& [suffix, value] : { std::pair{ "_mean", series.mean }, std::pair{ "_p99", series.p99 } }) {
+            const auto name = series_name + suffix;
+            const auto base = readBaselineValue(baseline, csv, name);
+            if (!base || *base <= 0.0) {
+                continue;
+            }
+            const auto change = (value - *base) / *base * 100.0;
+            const auto worse = change > threshold_;
+            regressed |= worse;
+            out << "  " << name << ": " << *base << " -> " << value << " (" << std::showpos << change << std::noshowpos << "%)"
+                << (worse ? " REGRESSION" : "") << "\n";
+        }
+    }
+    out.flags(flags);
+    out.precision(precision);
+    return !regressed;
+}
@@ -1,23 +1,30 @@
 #include <glfw/glfw3.h>
 
 #include "framework.hpp"
+#include "trace.hpp"
 
 namespace impl {
 
 DLL_EXPORT bool Window::shouldClose()
 {
-    return glfwWindowShouldClose(window_.get());
+    return window_ && glfwWindowShouldClose(window_.get());
 }
 
 DLL_EXPORT void Window::pollEvents()
 {
-    glfwPollEvents();
+    if (window_) {
+        glfwPollEvents();
+    }
 }
 
-DLL_EXPORT Window::Window(uint32_t width, uint32_t height, std::string_view title, const HintsList hints) noexcept
+DLL_EXPORT Window::Window(uint32_t width, uint32_t height, std::string_view title, const HintsList hints, bool headless) noexcept
     : width_{ width }
     , height_{ height }
+    , headless_{ headless }
 {
+    if (headless_) {
+        return;
+    }
     glfwInit();
     for (const auto& [hint, value] : hints) {
         glfwWindowHint(hint, value);
@@ -40,6 +47,12 @@ void Window::keyCallback(GLFWwindow* window, int key, int scancode, int action,
     if (key == GLFW_KEY_ESCAPE && action == GLFW_RELEASE) {
         glfwSetWindowShouldClose(window, GLFW_TRUE);
     }
+#ifdef TRACING
+    // the trace so far, without waiting for the end of the run
+    if (key == GLFW_KEY_F12 && action == GLFW_RELEASE) {
+        IGNORE(trace::dump());
+    }
+#endif // TRACING
 }
 
 DLL_EXPORT std::string Window::getGlfwErrorDescription()
@@ -49,4 +62,23 @@ DLL_EXPORT std::string Window::getGlfwErrorDescription()
     return descr;
 }
 
+DLL_EXPORT void CommandQueue::sortCommands(std::vector<Command*>& commands)
+{
+    auto first = commands.begin();
+    while (first != commands.end()) {
+        sort_keys_.clear();
+        auto last = first;
+        for (; last != commands.end(); ++last) {
+            const auto key = (*last)->sortKey();
+            if (!key) {
+                break;
+            }
+            sort_keys_.emplace_back(*key, *last);
+        }
+        util::radix_sort(sort_keys_, sort_scratch_);
+        std::ranges::transform(sort_keys_, first, [](const auto& item) { return item.second; });
+        first = (last == commands.end()) ? last : std::next(last);
+    }
+}
+
 } // namespace impl
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "memory_stats.hpp"
+
+namespace {
+
+constexpr std::array HeapNames{ "host", "device" };
+constexpr std::array CategoryNames{ "geometry", "uniforms", "staging", "images", "shader code", "shadow copies" };
+
+std::string formatBytes(size_t bytes)
+{
+    std::ostringstream out{};
+    out << std::fixed << std::setprecision(1);
+    if (bytes >= 1024 * 1024) {
+        out << bytes / (1024.0 * 1024.0) << " MiB";
+    }
+    else if (bytes >= 1024) {
+        out << bytes / 1024.0 << " KiB";
+    }
+    else {
+        out << bytes << " B";
+    }
+    return out.str();
+}
+
+} // namespace
+
+DLL_EXPORT MemoryStats::Allocation::Allocation(Heap heap, Category category, size_t bytes) noexcept
+    : heap_{ heap }
+    , category_{ category }
+    , bytes_{ bytes }
+{
+    MemoryStats::instance().add(heap_, category_, bytes_);
+}
+
+DLL_EXPORT MemoryStats::Allocation::Allocation(Allocation&& rhs) noexcept
+    : heap_{ rhs.heap_ }
+    , category_{ rhs.category_ }
+    , bytes_{ std::exchange(rhs.bytes_, 0) }
+{}
+
+DLL_EXPORT MemoryStats::Allocation& MemoryStats::Allocation::operator=(Allocation&& rhs) noexcept
+{
+    if (this != &rhs) {
+        resize(0);
+        heap_ = rhs.heap_;
+        category_ = rhs.category_;
+        bytes_ = std::exchange(rhs.bytes_, 0);
+    }
+    return *this;
+}
+
+DLL_EXPORT MemoryStats::Allocation::~Allocation()
+{
+    resize(0);
+}
+
+DLL_EXPORT void MemoryStats::Allocation::resize(size_t bytes)
+{
+    if (bytes > bytes_) {
+        MemoryStats::instance().add(heap_, category_, bytes - bytes_);
+    }
+    else if (bytes < bytes_) {
+        MemoryStats::instance().remove(heap_, category_, bytes_ - bytes);
+    }
+    bytes_ = bytes;
+}
+
+DLL_EXPORT MemoryStats& MemoryStats::instance()
+{
+    // never destroyed, globals such as the window release their allocations during static destruction
+    static auto* stats = new MemoryStats{};
+    return *stats;
+}
+
+DLL_EXPORT MemoryStats::Usage MemoryStats::usage(Heap heap, Category category) const
+{
+    std::lock_guard lock{ mutex_ };
+    return usage_[static_cast<size_t>(heap)][static_cast<size_t>(category)];
+}
+
+DLL_EXPORT MemoryStats::Usage MemoryStats::total(Heap heap) const
+{
+    std::lock_guard lock{ mutex_ };
+    return totals_[static_cast<size_t>(heap)];
+}
+
+DLL_EXPORT void MemoryStats::print(std::ostream& out, std::string_view when) const
+{
+    std::lock_guard lock{ mutex_ };
+    out << "Memory at " << when << " (current / peak):\n";
+    for (size_t heap = 0; heap != HeapCount; ++heap) {
+        out << "  " << HeapNames[heap] << ": " << formatBytes(totals_[heap].current) << " / " << formatBytes(totals_[heap].peak) << "\n";
+        for (size_t category = 0; category != CategoryCount; ++category) {
+            const auto& [current, peak] = usage_[heap][category];
+            if (peak != 0) {
+                out << "    " << CategoryNames[category] << ": " << formatBytes(current) << " / " << formatBytes(peak) << "\n";
+            }
+        }
+    }
+}
+
+void MemoryStats::add(Heap heap, Category category, size_t bytes)
+{
+    std::lock_guard lock{ mutex_ };
+    for (auto* usage : { &usage_[static_cast<size_t>(heap)][static_cast<size_t>(category)], &totals_[static_cast<size_t>(heap)] }) {
+        usage->current += bytes;
+        usage->peak = std::max(usage->peak, usage->current);
+    }
+}
+
+void MemoryStats::remove(Heap heap, Category category, size_t bytes)
+{
+    std::lock_guard lock{ mutex_ };
+    usage_[static_cast<size_t>(heap)][static_cast<size_t>(category)].current -= bytes;
+    totals_[static_cast<size_t>(heap)].current -= bytes;
+}
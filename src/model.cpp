@@ -1,6 +1,8 @@
 #include <array>
 
 #include "model.hpp"
+#include "startup_profile.hpp"
+#include "trace.hpp"
 
 namespace off {
 namespace {
@@ -31,7 +33,12 @@ void readIndices(std::string_view row, std::vector<uint32_t>& indices)
 
 DLL_EXPORT Model fromFile(std::string_view path)
 {
-    auto file_contains = util::read_file_contents(path);
+    TRACE_ZONE("off::fromFile");
+    auto file_contains = [&]() {
+        const auto stage = StartupProfile::instance().stage("read");
+        return util::read_file_contents(path);
+    }();
+    const auto parse_stage = StartupProfile::instance().stage("parse");
 
     const auto begin_2nd_row = file_contains.find_first_of('\n') + 1;
     const auto end_2nd_row = file_contains.substr(begin_2nd_row + 1).find_first_of('\n') + 1;
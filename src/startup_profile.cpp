@@ -0,0 +1,123 @@
+#include "startup_profile.hpp"
+
+namespace {
+
+// stages still running on this thread, innermost last
+thread_local std::vector<size_t> open_stages;
+
+} // namespace
+
+DLL_EXPORT StartupProfile::Stage::Stage(Stage&& rhs) noexcept
+    : profile_{ std::exchange(rhs.profile_, nullptr) }
+    , node_{ rhs.node_ }
+{}
+
+DLL_EXPORT StartupProfile::Stage::~Stage()
+{
+    if (profile_) {
+        profile_->finish(node_);
+    }
+}
+
+StartupProfile::Stage::Stage(StartupProfile& profile, size_t node) noexcept
+    : profile_{ &profile }
+    , node_{ node }
+{}
+
+DLL_EXPORT StartupProfile& StartupProfile::instance()
+{
+    static StartupProfile profile{};
+    return profile;
+}
+
+DLL_EXPORT StartupProfile::Stage StartupProfile::stage(std::string_view name)
+{
+    return start(name, open_stages.empty() ? NoParent : open_stages.back());
+}
+
+DLL_EXPORT StartupProfile::Stage StartupProfile::stage(std::string_view name, const Stage& parent)
+{
+    return start(name, parent.node_);
+}
+
+StartupProfile::Stage StartupProfile::start(std::string_view name, size_t parent)
+{
+    std::lock_guard lock{ mutex_ };
+    const auto node = nodes_.size();
+    const auto now = std::chrono::steady_clock::now();
+    nodes_.push_back({ std::string{ name }, parent, now, now });
+    open_stages.push_back(node);
+    return Stage{ *this, node };
+}
+
+void StartupProfile::finish(size_t node)
+{
+    {
+        std::lock_guard lock{ mutex_ };
+        nodes_[node].end = std::chrono::steady_clock::now();
+    }
+    std::erase(open_stages, node);
+}
+
+DLL_EXPORT void StartupProfile::print(std::ostream& out) const
+{
+    std::lock_guard lock{ mutex_ };
+    for (size_t node = 0; node != nodes_.size(); ++node) {
+        if (nodes_[node].parent == NoParent) {
+            printNode(out, node, 0);
+        }
+    }
+}
+
+void StartupProfile::printNode(std::ostream& out, size_t node, size_t depth) const
+{
+    const auto& [name, parent, start, end] = nodes_[node];
+    out << std::string(depth * 2, ' ') << name << ": " << std::chrono::duration_cast<std::chrono::microseconds>(end - start) << "\n";
+    for (size_t child = node + 1; child != nodes_.size(); ++child) {
+        if (nodes_[child].parent == node) {
+            printNode(out, child, depth + 1);
+        }
+    }
+}
+
+DLL_EXPORT bool StartupProfile::write(std::string_view path) const
+{
+    std::ofstream out{ std::string{ path } };
+    if (!out) {
+        return util::handle_error() << "cannot open " << path;
+    }
+    std::lock_guard lock{ mutex_ };
+    std::chrono::steady_clock::duration total{};
+    for (const auto& node : nodes_) {
+        if (node.parent == NoParent) {
+            total += node.end - node.start;
+        }
+    }
+    out << "{ \"name\": \"startup\", \"value\": " << std::chrono::duration_cast<std::chrono::microseconds>(total).count() << ", \"children\": [";
+    bool first = true;
+    for (size_t node = 0; node != nodes_.size(); ++node) {
+        if (nodes_[node].parent == NoParent) {
+            out << (std::exchange(first, false) ? "\n" : ",\n");
+            writeNode(out, node, 1);
+        }
+    }
+    out << "\n] }\n";
+    return true;
+}
+
+void StartupProfile::writeNode(std::ostream& out, size_t node, size_t depth) const
+{
+    const auto& [name, parent, start, end] = nodes_[node];
+    const auto offset = std::chrono::duration_cast<std::chrono::microseconds>(start - nodes_.front().start);
+    out << std::string(depth * 2, ' ') << "{ \"name\": \"" << util::json_escape(name) << "\""
+        << ", \"value\": " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+        << ", \"start_us\": " << offset.count() << ", \"children\": [";
+    bool first = true;
+    for (size_t child = node + 1; child != nodes_.size(); ++child) {
+        if (nodes_[child].parent == node) {
+            out << (std::exchange(first, false) ? "\n" : ",\n");
+            writeNode(out, child, depth + 1);
+        }
+    }
+    out << (first ? "] }" : "\n" + std::string(depth * 2, ' ') + "] }");
+}
@@ -0,0 +1,105 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+#include "config.hpp"
+#include "trace.hpp"
+
+namespace trace {
+namespace {
+
+struct Event
+{
+    const char* name;
+    uint64_t    start;
+    uint64_t    end;
+};
+
+// written only by its thread, read by dump() up to count; full buffers drop events instead of wrapping,
+// so nothing a reader may be looking at is overwritten
+struct ThreadBuffer
+{
+    static constexpr size_t Capacity = 1 << 16;
+
+    explicit ThreadBuffer(size_t id)
+        : id{ id }
+        , events{ new Event[Capacity] }
+    {}
+
+    const size_t             id;
+    std::unique_ptr<Event[]> events;
+    std::atomic<size_t>      count = 0;
+    std::atomic<size_t>      dropped = 0;
+};
+
+// buffers outlive their threads, so events of finished threads are still dumped
+std::mutex g_buffers_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+ThreadBuffer& threadBuffer()
+{
+    thread_local ThreadBuffer* buffer = [] {
+        std::lock_guard lock{ g_buffers_mutex };
+        return g_buffers.emplace_back(std::make_unique<ThreadBuffer>(g_buffers.size())).get();
+    }();
+    return *buffer;
+}
+
+} // namespace
+
+DLL_EXPORT uint64_t now() noexcept
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+DLL_EXPORT void record(const char* name, uint64_t start, uint64_t end) noexcept
+{
+    auto& buffer = threadBuffer();
+    const auto index = buffer.count.load(std::memory_order_relaxed);
+    if (index == ThreadBuffer::Capacity) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[index] = { name, start, end };
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+DLL_EXPORT bool dump(std::string_view path)
+{
+    std::ofstream out{ std::string{ path } };
+    if (!out) {
+        return util::handle_error() << "cannot open " << path;
+    }
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool first = true;
+    std::lock_guard lock{ g_buffers_mutex };
+    for (const auto& buffer : g_buffers) {
+        const auto count = buffer->count.load(std::memory_order_acquire);
+        out << (std::exchange(first, false) ? "\n" : ",\n")
+            << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":\"thread " << buffer->id << "\"}}";
+        for (size_t i = 0; i != count; ++i) {
+            const auto& [name, start, end] = buffer->events[i];
+            // complete events, timestamps in microseconds
+            out << ",\n{\"ph\":\"X\",\"name\":\"" << util::json_escape(name) << "\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"ts\":" << start / 1000.0 << ",\"dur\":" << (end - start) / 1000.0 << "}";
+        }
+        if (const auto dropped = buffer->dropped.load(std::memory_order_relaxed)) {
+            std::cout << "Trace buffer of thread " << buffer->id << " was full, " << dropped << " zones dropped\n";
+        }
+    }
+    out << "\n]}\n";
+    std::cout << "Trace written to " << path << "\n";
+    return true;
+}
+
+DLL_EXPORT bool dump()
+{
+    const auto path = Config::instance().get<std::string>("trace_output");
+    return !path || dump(*path);
+}
+
+} // namespace trace
@@ -28,7 +28,7 @@ private:
 
     static Opt<std::vector<std::string>> getRequiredInstanceExtensionNames();
     static Opt<std::vector<std::string>> getAvailableInstanceExtensionsNames();
-    static bool checkInstanceExtensions(const std::vector<std::string>& extensions);
+    static bool checkInstanceExtensions(const std::vector<std::string>& extensions, bool headless);
 
     static VkApplicationInfo initApplicationInfo();
     static VkInstanceCreateInfo initInstanceCreateInfo(
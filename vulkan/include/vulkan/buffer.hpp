@@ -13,6 +13,7 @@ enum class BufferUsage
 {
       Vertex = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
     , Index = VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+    , Storage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
 };
 
 struct BufferFlags
@@ -24,25 +25,28 @@ struct BufferFlags
 
 class BufferHandle : public impl::BufferHandle
 {
+    friend class CommandQueue;
+    friend class ComputePipeline;
     friend class DrawCommand;
 
 protected:
     BufferHandle(const Window& window, VkBuffer buffer, uint32_t size, uint32_t elem_count);
     ~BufferHandle();
 
-    bool initBufferBase();
+    bool initBufferBase(MemoryStats::Category category);
     static Opt<VkBuffer> initBuffer(const Window& window, VkBufferUsageFlags usage, uint32_t size);
     static VkBufferCreateInfo initBufferCreateInfo(VkBufferUsageFlags usage, uint32_t size);
     Opt<VkMemoryAllocateInfo> initMemoryAllocateInfo();
 
 protected:
-    const VkPhysicalDevice physical_device_;
-    const VkDevice         device_;
-    const VkBuffer         buffer_;
-    const uint32_t         size_;
-    const uint32_t         elem_count_;
-    VkDeviceMemory         device_memory_;
-    void*                  mapped_;
+    const VkPhysicalDevice  physical_device_;
+    const VkDevice          device_;
+    const VkBuffer          buffer_;
+    const uint32_t          size_;
+    const uint32_t          elem_count_;
+    VkDeviceMemory          device_memory_;
+    void*                   mapped_;
+    MemoryStats::Allocation device_allocation_;
 };
 
 template<typename T>
@@ -6,33 +6,45 @@
 #include <vulkan/vulkan.h>
 
 #include "buffer.hpp"
+#include "compute_pipeline.hpp"
 #include "framework.hpp"
+#include "geometry_pool.hpp"
 #include "pipeline.hpp"
+#include "uniform_buffer_object.hpp"
 
 namespace vulkan {
 namespace details {
 
-class DepthImage
+// device local image with a view, the depth buffer and the color targets of a headless window
+class AttachmentImage
 {
     friend class CommandQueue;
 
 public:
-    static Ptr<DepthImage> create(VkPhysicalDevice physical_device, VkDevice device) noexcept;
-    ~DepthImage();
+    static Ptr<AttachmentImage> create(
+          VkPhysicalDevice   physical_device
+        , VkDevice           device
+        , VkFormat           format
+        , VkImageUsageFlags  usage
+        , VkImageAspectFlags aspect) noexcept;
+    ~AttachmentImage();
 
 private:
-    DepthImage(VkPhysicalDevice physical_device, VkDevice device) noexcept;
+    AttachmentImage(VkPhysicalDevice physical_device, VkDevice device, VkFormat format, VkImageAspectFlags aspect) noexcept;
 
-    static VkImageCreateInfo initImageCreateInfo(uint32_t width, uint32_t height);
+    static VkImageCreateInfo initImageCreateInfo(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage);
     std::optional<uint32_t> findMemoryType(uint32_t type_filter);
     VkImageViewCreateInfo initImageViewCreateInfo();
 
 private:
-    const VkPhysicalDevice physical_device_;
-    const VkDevice         device_;
-    VkImage                image_;
-    VkDeviceMemory         image_memory_;
-    VkImageView            image_view_;
+    const VkPhysicalDevice   physical_device_;
+    const VkDevice           device_;
+    const VkFormat           format_;
+    const VkImageAspectFlags aspect_;
+    VkImage                  image_ = VK_NULL_HANDLE;
+    VkDeviceMemory           image_memory_ = VK_NULL_HANDLE;
+    VkImageView              image_view_ = VK_NULL_HANDLE;
+    MemoryStats::Allocation  image_allocation_;
 };
 
 } // namespace details
@@ -40,6 +52,7 @@ private:
 class CommandQueue : public impl::CommandQueue
 {
     friend class ClearCommand;
+    friend class DispatchCommand;
     friend class DrawCommand;
     friend class Window;
 
@@ -48,16 +61,22 @@ public:
     DLL_EXPORT ~CommandQueue();
 
     DLL_EXPORT void addCommand(impl::Command& command) override;
+    // makes a storage buffer reachable from shaders through the bindless array, returns its index there
+    DLL_EXPORT Opt<uint32_t> addObjectBuffer(const BufferHandle& buffer);
 
 private:
-    CommandQueue(VkDevice device, VkPipelineLayout pipeline_layout) noexcept;
+    CommandQueue(VkDevice device, VkPipelineLayout pipeline_layout, uint32_t bindless_descriptor_count) noexcept;
     bool recordCommandBuffer();
     void acquireNextImage(VkSemaphore image_available_semaphore);
+    bool writeFrameDescriptorSet();
 
-    static VkDescriptorPoolCreateInfo initDescriptorPoolCreateInfo(const VkDescriptorPoolSize& size);
-    VkDescriptorSetAllocateInfo       initDescriptorSetAllocateInfo(const std::vector<VkDescriptorSetLayout>& layouts);
     static VkDescriptorBufferInfo     initDescriptorBufferInfo(VkBuffer buffer, VkDeviceSize ubo_size);
-    static VkWriteDescriptorSet       infoWriteDescriptorSet(VkDescriptorSet descriptor_set, const VkDescriptorBufferInfo& dbi);
+    static VkWriteDescriptorSet       infoWriteDescriptorSet(
+          VkDescriptorSet               descriptor_set
+        , VkDescriptorType              type
+        , uint32_t                      binding
+        , uint32_t                      array_element
+        , const VkDescriptorBufferInfo& dbi);
 
     Opt<std::vector<VkImage>>         getSwapchainImages(VkSwapchainKHR swapchain);
     static VkImageViewCreateInfo      initImageViewCreateInfo(VkImage image, VkFormat format);
@@ -73,17 +92,27 @@ private:
 private:
     const VkDevice               device_;
     const VkPipelineLayout       pipeline_layout_;
+    const uint32_t               bindless_descriptor_count_;
     VkRenderPass                 render_pass_;
     VkPipeline                   pipeline_;
-    VkDescriptorPool             descriptor_pool_;
-    std::vector<VkDescriptorSet> descriptor_sets_;
+    DescriptorSetLayout          descriptor_set_layout_; // owned by the window's descriptor allocator
+    std::vector<details::BufferInfo> uniform_buffers_;   // one uniform block copy per frame slot
+    std::vector<VkDescriptorBufferInfo> object_buffers_; // the bindless array, in the order they were added
+    VkDescriptorSet              frame_descriptor_set_ = VK_NULL_HANDLE; // transient, rebuilt every frame
     std::vector<VkImageView>     image_views_;
     std::vector<VkFramebuffer>   framebuffers_;
-    Ptr<details::DepthImage>     depth_image_;
-    VkCommandPool                command_pool_;
+    Ptr<details::AttachmentImage> depth_image_;
+    std::vector<Ptr<details::AttachmentImage>> color_images_; // headless only, stand in for the swapchain images
+    VkCommandPool                command_pool_ = VK_NULL_HANDLE;
     std::vector<VkCommandBuffer> command_buffers_;
     std::vector<impl::Command*>  commands_;
     uint32_t                     current_image_index_ = 0;
+    bool                         render_pass_begun_ = false;
+    details::GpuProfiler*        gpu_profiler_ = nullptr;
+    uint32_t                     current_frame_ = 0; // frame slot of the queries and uniform copies, not the image index
+    VkPipeline                   bound_pipeline_ = VK_NULL_HANDLE;
+    VkDescriptorSet              bound_descriptor_set_ = VK_NULL_HANDLE;
+    const GeometryPoolHandle*    bound_geometry_ = nullptr;
 };
 
 class ClearCommand : public impl::Command
@@ -105,18 +134,46 @@ private:
     const VkExtent2D extent_;
 };
 
-class DrawCommand : public impl::Command
+// has to come before the ClearCommand: the clear begins the render pass and dispatches can't be recorded inside one,
+// so a dispatch added after it is refused
+class DispatchCommand : public impl::Command
 {
 public:
-    DLL_EXPORT static Ptr<DrawCommand> create(const impl::BufferHandle& vertex_buffer, const impl::BufferHandle& index_buffer) noexcept;
+    DLL_EXPORT static Ptr<DispatchCommand> create(const impl::ComputePipeline& pipeline, uint32_t x, uint32_t y = 1, uint32_t z = 1) noexcept;
     DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
 
 private:
-    DrawCommand(const BufferHandle& vertex_buffer, const BufferHandle& index_buffer) noexcept;
+    DispatchCommand(const ComputePipeline& pipeline, uint32_t x, uint32_t y, uint32_t z) noexcept;
+
+    static VkMemoryBarrier initMemoryBarrier();
+
+private:
+    const ComputePipeline& pipeline_;
+    const uint32_t         x_, y_, z_;
+};
+
+class DrawCommand : public impl::DrawCommand
+{
+public:
+    DLL_EXPORT static Ptr<DrawCommand> create(
+          const impl::Pipeline&           pipeline
+        , const impl::GeometryPoolHandle& geometry
+        , const impl::GeometryRange&      range) noexcept;
+    DLL_EXPORT void operator()(impl::CommandQueue& queue) override;
+
+    DrawData& drawData() { return draw_data_; }
+    // element of the bindless array holding the draw's ObjectData, see CommandQueue::addObjectBuffer
+    void setDrawIndex(uint32_t draw_index) { draw_index_ = draw_index; }
+
+private:
+    DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry, const impl::GeometryRange& range) noexcept;
 
 private:
-    const BufferHandle& vertex_buffer_;
-    const BufferHandle& index_buffer_;
+    const Pipeline&           pipeline_;
+    const GeometryPoolHandle& geometry_;
+    const impl::GeometryRange range_;
+    DrawData                  draw_data_;
+    uint32_t                  draw_index_ = 0;
 };
 
 } // namespace vulkan
@@ -0,0 +1,48 @@
+#ifndef VULKAN_COMPUTE_PIPELINE_HPP
+#define VULKAN_COMPUTE_PIPELINE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "buffer.hpp"
+#include "descriptor_allocator.hpp"
+#include "framework.hpp"
+#include "glsl_shader.hpp"
+#include "pipeline.hpp"
+
+namespace vulkan {
+
+// dispatched by DispatchCommand, which has to be added to the queue before the ClearCommand that begins the render pass
+class ComputePipeline : public impl::ComputePipeline
+{
+    friend class DispatchCommand;
+
+public:
+    DLL_EXPORT static Ptr<ComputePipeline> create() noexcept;
+    DLL_EXPORT ~ComputePipeline() noexcept;
+
+    DLL_EXPORT void setShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants = {}) override;
+    DLL_EXPORT void addStorageBuffer(uint32_t binding, const impl::BufferHandle& buffer) override;
+    DLL_EXPORT bool use() override;
+
+private:
+    ComputePipeline(VkDevice device, VkPipelineCache pipeline_cache) noexcept;
+
+    static VkWriteDescriptorSet initWriteDescriptorSet(VkDescriptorSet descriptor_set, uint32_t binding, const VkDescriptorBufferInfo& dbi);
+    VkPipelineLayoutCreateInfo  initPipelineLayoutCreateInfo();
+    VkComputePipelineCreateInfo initComputePipelineCreateInfo(const VkPipelineShaderStageCreateInfo& pssci);
+
+private:
+    const VkDevice               device_;
+    const VkPipelineCache        pipeline_cache_; // shared by all pipelines, owned by the window
+    const GlslShader*            shader_ = nullptr;
+    Ptr<details::Specialization> specialization_;
+    std::vector<std::pair<uint32_t, VkDescriptorBufferInfo>> storage_buffers_;
+    DescriptorSetLayout          descriptor_set_layout_; // owned by the window's descriptor allocator
+    VkDescriptorSet              descriptor_set_ = VK_NULL_HANDLE;
+    VkPipelineLayout             pipeline_layout_ = VK_NULL_HANDLE;
+    VkPipeline                   pipeline_ = VK_NULL_HANDLE;
+};
+
+} // namespace vulkan
+
+#endif // VULKAN_COMPUTE_PIPELINE_HPP
@@ -0,0 +1,128 @@
+#ifndef VULKAN_DESCRIPTOR_ALLOCATOR_HPP
+#define VULKAN_DESCRIPTOR_ALLOCATOR_HPP
+
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "framework.hpp"
+
+namespace vulkan {
+
+struct DescriptorSetLayout
+{
+    VkDescriptorSetLayout             layout            = VK_NULL_HANDLE;
+    std::vector<VkDescriptorPoolSize> sizes;                  // descriptors a single set takes
+    uint32_t                          variable_count    = 0;  // size of the variable sized binding, 0 if there is none
+    bool                              update_after_bind = false;
+};
+
+namespace details {
+
+// maxUpdateAfterBindDescriptorsInAllPools is device wide, every chain draws from the same budget
+struct UpdateAfterBindBudget
+{
+    const uint32_t limit;
+    uint32_t       used = 0; // in the update-after-bind pools created so far, resets keep the pools
+};
+
+// every layout has its own chain of pools sized for its sets, a new pool is chained when the last one runs out;
+// sets are never freed one by one but reset together with their pools
+class DescriptorPoolChain
+{
+    static constexpr uint32_t InitialSetsPerPool = 16;
+    static constexpr uint32_t MaxSetsPerPool     = 4096;
+
+public:
+    DescriptorPoolChain(VkDevice device, UpdateAfterBindBudget& update_after_bind_budget) noexcept;
+    ~DescriptorPoolChain();
+
+    Opt<VkDescriptorSet> allocate(const DescriptorSetLayout& layout);
+    bool reset();
+
+private:
+    struct Pools
+    {
+        std::vector<VkDescriptorPool> pools;
+        size_t                        current       = 0;
+        uint32_t                      sets_per_pool = InitialSetsPerPool;
+    };
+
+    VkResult allocateFrom(VkDescriptorPool pool, const DescriptorSetLayout& layout, VkDescriptorSet& set);
+    Opt<VkDescriptorPool> createPool(const DescriptorSetLayout& layout, Pools& chain);
+
+    static VkDescriptorPoolCreateInfo initDescriptorPoolCreateInfo(
+          uint32_t                                 max_sets
+        , const std::vector<VkDescriptorPoolSize>& sizes
+        , bool                                     update_after_bind);
+    static VkDescriptorSetVariableDescriptorCountAllocateInfoEXT initDescriptorSetVariableDescriptorCountAllocateInfo(const uint32_t& count);
+    static VkDescriptorSetAllocateInfo initDescriptorSetAllocateInfo(
+          VkDescriptorPool                                             pool
+        , const VkDescriptorSetLayout&                                 layout
+        , const VkDescriptorSetVariableDescriptorCountAllocateInfoEXT* dsvdcai);
+
+private:
+    const VkDevice                                   device_;
+    UpdateAfterBindBudget&                           update_after_bind_budget_; // owned by the allocator
+    std::unordered_map<VkDescriptorSetLayout, Pools> pools_;
+};
+
+} // namespace details
+
+// safe to use from several threads, pipelines are created in parallel
+class DescriptorAllocator
+{
+public:
+    static Ptr<DescriptorAllocator> create(VkDevice device, uint32_t frame_count, uint32_t update_after_bind_limit) noexcept;
+    ~DescriptorAllocator();
+
+    // identical layouts are created once and shared
+    Opt<DescriptorSetLayout> getLayout(
+          const std::vector<VkDescriptorSetLayoutBinding>& bindings
+        , const std::vector<VkDescriptorBindingFlagsEXT>&  binding_flags);
+
+    // lives as long as the allocator
+    Opt<VkDescriptorSet> allocate(const DescriptorSetLayout& layout);
+    // lives until the current frame slot comes round again
+    Opt<VkDescriptorSet> allocateTransient(const DescriptorSetLayout& layout);
+    // the slot's previous frame has to be finished, its sets all go at once with vkResetDescriptorPool
+    bool beginFrame(uint32_t frame);
+
+private:
+    struct CachedLayout
+    {
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        std::vector<VkDescriptorBindingFlagsEXT>  binding_flags;
+        DescriptorSetLayout                       layout;
+    };
+
+    DescriptorAllocator(VkDevice device, uint32_t update_after_bind_limit) noexcept;
+
+    static size_t hashLayout(
+          const std::vector<VkDescriptorSetLayoutBinding>& bindings
+        , const std::vector<VkDescriptorBindingFlagsEXT>&  binding_flags);
+    static bool sameLayout(
+          const CachedLayout&                              cached
+        , const std::vector<VkDescriptorSetLayoutBinding>& bindings
+        , const std::vector<VkDescriptorBindingFlagsEXT>&  binding_flags);
+
+    static VkDescriptorSetLayoutBindingFlagsCreateInfoEXT initDescriptorSetLayoutBindingFlagsCreateInfo(const std::vector<VkDescriptorBindingFlagsEXT>& flags);
+    static VkDescriptorSetLayoutCreateInfo initDescriptorSetLayoutCreateInfo(
+          const std::vector<VkDescriptorSetLayoutBinding>&      bindings
+        , const VkDescriptorSetLayoutBindingFlagsCreateInfoEXT& dslbfci
+        , bool                                                  update_after_bind);
+
+private:
+    const VkDevice                                        device_;
+    std::unordered_map<size_t, std::vector<CachedLayout>> layouts_;
+    details::UpdateAfterBindBudget                        update_after_bind_budget_;
+    Ptr<details::DescriptorPoolChain>                     persistent_;
+    std::vector<Ptr<details::DescriptorPoolChain>>        frames_;
+    uint32_t                                              current_frame_ = 0;
+    std::mutex                                            mutex_;
+};
+
+} // namespace vulkan
+
+#endif // VULKAN_DESCRIPTOR_ALLOCATOR_HPP
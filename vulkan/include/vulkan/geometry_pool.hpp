@@ -0,0 +1,61 @@
+#ifndef VULKAN_GEOMETRY_POOL_HPP
+#define VULKAN_GEOMETRY_POOL_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "buffer.hpp"
+#include "framework.hpp"
+
+namespace vulkan {
+
+class CommandQueue;
+class GeometryPoolHandle;
+class Window;
+
+namespace details {
+
+class PoolBuffer : public BufferHandle
+{
+    friend class vulkan::CommandQueue;
+    friend class vulkan::GeometryPoolHandle;
+
+public:
+    static Ptr<PoolBuffer> create(const Window& window, BufferUsage usage, MemoryStats::Category category, uint32_t capacity) noexcept;
+
+private:
+    PoolBuffer(const Window& window, VkBuffer buffer, uint32_t capacity) noexcept;
+};
+
+} // namespace details
+
+class GeometryPoolHandle : public impl::GeometryPoolHandle
+{
+    friend class DrawCommand;
+
+protected:
+    GeometryPoolHandle(const Window& window) noexcept;
+
+    bool write(Ptr<details::PoolBuffer>& buffer, BufferUsage usage, const void* data, size_t offset, size_t size);
+    void bind(VkCommandBuffer command_buffer) const;
+
+protected:
+    const Window&            window_;
+    Ptr<details::PoolBuffer> vertex_buffer_;
+    Ptr<details::PoolBuffer> index_buffer_;
+};
+
+template<typename V>
+class GeometryPool : public GeometryPoolHandle, public impl::GeometryPool<V>
+{
+public:
+    DLL_EXPORT static Ptr<GeometryPool> create() noexcept;
+
+private:
+    GeometryPool(const Window& window) noexcept;
+
+    bool upload(size_t first_vertex, size_t first_index) override;
+};
+
+} // namespace vulkan
+
+#endif // VULKAN_GEOMETRY_POOL_HPP
@@ -1,6 +1,8 @@
 #ifndef VULKAN_GLSL_SHADER_HPP
 #define VULKAN_GLSL_SHADER_HPP
 
+#include <span>
+
 #include <shaderc/shaderc.hpp>
 #include <vulkan/vulkan.h>
 
@@ -13,8 +15,10 @@ class UniformBlockBase;
 
 struct BufferInfo
 {
-    VkBuffer buffer;
-    uint32_t size;
+    VkBuffer              buffer;
+    uint32_t              size;
+    uint32_t              binding;
+    VkShaderStageFlagBits stage;
 };
 
 } // namespace details
@@ -23,32 +27,41 @@ enum class ShaderType : std::underlying_type_t<VkShaderStageFlagBits>
 {
       Vertex = VK_SHADER_STAGE_VERTEX_BIT
     , Fragment = VK_SHADER_STAGE_FRAGMENT_BIT
+    , Compute = VK_SHADER_STAGE_COMPUTE_BIT
 };
 
 class GlslShader : public impl::GlslShader
 {
+    friend class ComputePipeline;
     friend class Pipeline;
     friend class details::UniformBlockBase;
 
 public:
     DLL_EXPORT static Ptr<GlslShader> create(ShaderType type, std::string_view path) noexcept;
+    DLL_EXPORT static Ptr<GlslShader> create(ShaderType type, std::span<const uint32_t> spirv) noexcept;
     DLL_EXPORT ~GlslShader();
 
 private:
+    // part of the SPIR-V cache key, changing it invalidates cached shaders
+    static constexpr shaderc_optimization_level OptimizationLevel = shaderc_optimization_level_zero;
+
     GlslShader(VkDevice device, VkShaderStageFlagBits type) noexcept;
 
-    static VkShaderModuleCreateInfo initShaderModuleCreateInfo(const std::vector<uint32_t>& shader_code);
+    static Opt<std::vector<uint32_t>> compile(const std::string& shader_code, shaderc_shader_kind kind, std::string_view path);
+
+    static VkShaderModuleCreateInfo initShaderModuleCreateInfo(std::span<const uint32_t> shader_code);
     static shaderc_shader_kind getShadercShaderType(VkShaderStageFlagBits type);
 
-    void attachUniformBlock(VkDescriptorSetLayout layout, VkBuffer buffer, uint32_t buffer_size);
+    void attachUniformBlock(VkBuffer buffer, uint32_t buffer_size, uint32_t binding);
 
 private:
     const VkDevice              device_;
     const VkShaderStageFlagBits type_;
-    VkShaderModule              shader_;
+    VkShaderModule              shader_ = VK_NULL_HANDLE;
+    uint64_t                    code_hash_ = 0; // identifies the code in pipeline library keys, handles get reused
+    MemoryStats::Allocation     code_memory_;
 
-    std::vector<VkDescriptorSetLayout> descriptor_set_layouts_;
-    std::vector<details::BufferInfo>   uniform_buffers_;
+    std::vector<details::BufferInfo> uniform_buffers_;
 };
 
 namespace details {
@@ -61,9 +74,9 @@ protected:
         return shader.type_;
     }
 
-    void attachUniformBlock(GlslShader& shader, VkDescriptorSetLayout layout, VkBuffer buffer, uint32_t buffer_size)
+    void attachUniformBlock(GlslShader& shader, VkBuffer buffer, uint32_t buffer_size, uint32_t binding)
     {
-        shader.attachUniformBlock(layout, buffer, buffer_size);
+        shader.attachUniformBlock(buffer, buffer_size, binding);
     }
 };
 
@@ -0,0 +1,62 @@
+#ifndef VULKAN_GPU_PROFILER_HPP
+#define VULKAN_GPU_PROFILER_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "framework.hpp"
+
+namespace vulkan {
+namespace details {
+
+// one set of queries per frame in flight, a set is read back when its frame slot comes round again
+// and the fence of that slot has been waited on
+class GpuProfiler : public impl::GpuProfiler
+{
+    enum Timestamp : uint32_t
+    {
+        FrameBegin,
+        RenderPassBegin,
+        FrameEnd,
+        TimestampCount
+    };
+
+    // in the order the results come back, which is that of the flag bits
+    static constexpr VkQueryPipelineStatisticFlags Statistics =
+          VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT
+        | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+        | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT
+        | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT
+        | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+    static constexpr uint32_t StatisticCount = 5;
+
+public:
+    // null if the device supports neither timestamps on the queue nor pipeline statistics
+    static Ptr<GpuProfiler> create(VkPhysicalDevice physical_device, VkDevice device, uint32_t queue_family_index, uint32_t frame_count) noexcept;
+    ~GpuProfiler();
+
+    // outside of the render pass, before anything else is recorded
+    void begin(VkCommandBuffer command_buffer, uint32_t frame);
+    void beginRenderPass(VkCommandBuffer command_buffer, uint32_t frame);
+    // after the render pass has ended
+    void end(VkCommandBuffer command_buffer, uint32_t frame);
+
+private:
+    GpuProfiler(VkDevice device, uint32_t frame_count) noexcept;
+
+    void collect(uint32_t frame);
+
+    static VkQueryPoolCreateInfo initQueryPoolCreateInfo(VkQueryType type, uint32_t count, VkQueryPipelineStatisticFlags statistics);
+
+private:
+    const VkDevice    device_;
+    VkQueryPool       timestamps_ = VK_NULL_HANDLE; // null when the queue has no timestamps
+    VkQueryPool       statistics_ = VK_NULL_HANDLE; // null without the pipelineStatisticsQuery feature
+    double            timestamp_period_ = 1.0;      // nanoseconds per tick
+    uint64_t          timestamp_mask_ = 0;
+    std::vector<bool> recorded_;                    // whether the frame slot has queries to read back
+};
+
+} // namespace details
+} // namespace vulkan
+
+#endif // VULKAN_GPU_PROFILER_HPP
@@ -1,11 +1,17 @@
 #ifndef VULKAN_PROGRAM_HPP
 #define VULKAN_PROGRAM_HPP
 
+#include <array>
+#include <future>
+
 #include <shaderc/shaderc.hpp>
 #include <vulkan/vulkan.h>
 
+#include "descriptor_allocator.hpp"
 #include "framework.hpp"
 #include "glsl_shader.hpp"
+#include "pipeline_library.hpp"
+#include "uniform_buffer_object.hpp"
 
 namespace vulkan {
 namespace details {
@@ -15,7 +21,7 @@ class RenderPass
     friend class Pipeline;
 
 public:
-    static Ptr<RenderPass> create(VkDevice device, VkFormat surface_format) noexcept;
+    static Ptr<RenderPass> create(VkDevice device, VkFormat surface_format, VkImageLayout final_layout) noexcept;
     ~RenderPass();
 
     VkRenderPass get()
@@ -26,7 +32,7 @@ public:
 private:
     RenderPass(VkDevice device) noexcept;
 
-    static VkAttachmentDescription initColorAttachmentDescription(VkFormat surface_format);
+    static VkAttachmentDescription initColorAttachmentDescription(VkFormat surface_format, VkImageLayout final_layout);
     static VkAttachmentDescription initDepthAttachmentDescription();
     static VkSubpassDescription initSubpassDescription(const VkAttachmentReference& color_attachment, const VkAttachmentReference& depth_attachment);
     static VkSubpassDependency initColorSubpassDependency();
@@ -41,24 +47,47 @@ private:
     VkRenderPass                         render_pass_;
 };
 
+struct Specialization
+{
+    // nullptr when there is nothing to specialize
+    static Ptr<Specialization> create(const impl::SpecializationConstants& constants);
+    static VkSpecializationInfo initSpecializationInfo(const std::vector<VkSpecializationMapEntry>&, const std::vector<uint32_t>& data);
+
+    std::vector<VkSpecializationMapEntry> map_entries;
+    std::vector<uint32_t>                 data;
+    VkSpecializationInfo                  info;
+};
+
 } // namespace details
 
 class Pipeline : public impl::Pipeline
 {
     friend class CommandQueue;
+    friend class ComputePipeline;
+    friend class DrawCommand;
+
+    static constexpr VkPushConstantRange DrawConstantsRange{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(DrawConstants) };
 
 public:
     DLL_EXPORT static Ptr<Pipeline> create() noexcept;
     DLL_EXPORT ~Pipeline() noexcept;
 
-    DLL_EXPORT void addShader(const impl::GlslShader& shader) override;
+    DLL_EXPORT void addShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants = {}) override;
     DLL_EXPORT bool use(const impl::VertexDescription& description) override;
 
 private:
-    Pipeline(VkDevice device) noexcept;
+    Pipeline(VkDevice device, VkPipelineCache pipeline_cache) noexcept;
+
+    // switches to the optimized pipeline once it has been linked in the background
+    VkPipeline current() const;
+
+    // descriptor set layout and the code of the given stage
+    uint64_t getLayoutKey(VkShaderStageFlagBits stage) const;
+    // keys of the vertex input, pre-rasterization, fragment shader and fragment output parts
+    bool linkLibraries(details::PipelineLibraryCache& libraries, const VkGraphicsPipelineCreateInfo& gpci, const std::array<uint64_t, 4>& keys);
 
-    static VkPipelineShaderStageCreateInfo        initPipelineShaderStageCreateInfo(VkShaderModule, VkShaderStageFlagBits);
-    static VkPipelineCacheCreateInfo              initPipelineCacheCreateInfo();
+    static VkPipelineShaderStageCreateInfo        initPipelineShaderStageCreateInfo(VkShaderModule, VkShaderStageFlagBits, const VkSpecializationInfo*);
+    static VkDescriptorSetLayoutBinding           initDescriptorSetLayoutBinding(VkDescriptorType, uint32_t binding, VkShaderStageFlags, uint32_t count);
     VkPipelineVertexInputStateCreateInfo          initPipelineVertexInputStateCreateInfo(
           const VkVertexInputBindingDescription&
         , const std::vector<VkVertexInputAttributeDescription>&);
@@ -78,16 +107,23 @@ private:
         , const VkPipelineMultisampleStateCreateInfo&   pmsci
         , const VkPipelineDepthStencilStateCreateInfo&  pdssci
         , const VkPipelineColorBlendStateCreateInfo&    pcbsci);
+    static VkGraphicsPipelineLibraryCreateInfoEXT initGraphicsPipelineLibraryCreateInfo(VkGraphicsPipelineLibraryFlagsEXT flags);
+    static VkPipelineLibraryCreateInfoKHR         initPipelineLibraryCreateInfo(const std::array<VkPipeline, 4>& libraries);
+    VkGraphicsPipelineCreateInfo                  initLinkedGraphicsPipelineCreateInfo(const VkPipelineLibraryCreateInfoKHR& plci, VkPipelineCreateFlags flags);
 
 private:
     const VkDevice           device_;
-    VkPipelineCache          pipeline_cache_;
+    const VkPipelineCache    pipeline_cache_; // shared by all pipelines, owned by the window
+    DescriptorSetLayout      descriptor_set_layout_; // owned by the window's descriptor allocator
     VkPipelineLayout         pipeline_layout_;
     Ptr<details::RenderPass> render_pass_;
-    VkPipeline               pipeline_;
+    mutable VkPipeline       pipeline_ = VK_NULL_HANDLE;
+    mutable VkPipeline       retired_ = VK_NULL_HANDLE; // fast-linked, replaced by the optimized one
+    mutable std::future<VkPipeline> optimized_;
 
     std::vector<VkPipelineShaderStageCreateInfo> pipeline_shader_stage_create_infos_;
-    std::vector<VkDescriptorSetLayout>           descriptor_set_layouts_;
+    std::vector<uint64_t>                        shader_code_hashes_; // include the specialization constants
+    std::vector<Ptr<details::Specialization>>    specializations_; // pointed to by the stage create infos
     std::vector<details::BufferInfo>             uniform_buffers_;
 };
 
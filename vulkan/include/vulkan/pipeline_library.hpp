@@ -0,0 +1,38 @@
+#ifndef VULKAN_PIPELINE_LIBRARY_HPP
+#define VULKAN_PIPELINE_LIBRARY_HPP
+
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "framework.hpp"
+
+namespace vulkan {
+namespace details {
+
+// pipeline parts (VK_EXT_graphics_pipeline_library) keyed by a hash of the state they were built from,
+// created once and shared by every pipeline that links them
+class PipelineLibraryCache
+{
+public:
+    static Ptr<PipelineLibraryCache> create(VkDevice device, VkPipelineCache pipeline_cache) noexcept;
+    ~PipelineLibraryCache();
+
+    // gpci has to describe a library, the part it builds is expected to be part of the key
+    Opt<VkPipeline> get(uint64_t key, const VkGraphicsPipelineCreateInfo& gpci);
+
+private:
+    PipelineLibraryCache(VkDevice device, VkPipelineCache pipeline_cache) noexcept;
+
+private:
+    const VkDevice                           device_;
+    const VkPipelineCache                    pipeline_cache_;
+    std::unordered_map<uint64_t, VkPipeline> libraries_;
+    std::mutex                               mutex_;
+};
+
+} // namespace details
+} // namespace vulkan
+
+#endif // VULKAN_PIPELINE_LIBRARY_HPP
@@ -0,0 +1,53 @@
+#ifndef VULKAN_SPIRV_CACHE_HPP
+#define VULKAN_SPIRV_CACHE_HPP
+
+#include <filesystem>
+#include <mutex>
+
+#include <shaderc/shaderc.hpp>
+
+#include "framework.hpp"
+
+namespace vulkan {
+namespace details {
+
+// compiled shaders on disk, each file is named after a hash of everything that went into its compilation
+class SpirvCache
+{
+public:
+    struct Stats
+    {
+        uint32_t hits   = 0;
+        uint32_t misses = 0;
+    };
+
+public:
+    static Ptr<SpirvCache> create(std::string_view directory) noexcept;
+
+    static uint64_t makeKey(std::string_view path, std::string_view source, shaderc_shader_kind kind, shaderc_optimization_level optimization);
+
+    Opt<std::vector<uint32_t>> load(uint64_t key, std::string_view path);
+    bool store(uint64_t key, const std::vector<uint32_t>& spirv);
+
+    Stats getStats() const
+    {
+        std::lock_guard lock{ mutex_ };
+        return stats_;
+    }
+
+private:
+    SpirvCache(std::filesystem::path directory) noexcept;
+
+    static void hashIncludes(uint64_t& hash, const std::filesystem::path& path, std::string_view source, std::vector<std::filesystem::path>& visited);
+    std::filesystem::path getFilePath(uint64_t key) const;
+
+private:
+    const std::filesystem::path directory_;
+    Stats                       stats_;
+    mutable std::mutex          mutex_; // shaders are loaded from several threads
+};
+
+} // namespace details
+} // namespace vulkan
+
+#endif // VULKAN_SPIRV_CACHE_HPP
@@ -8,27 +8,25 @@
 namespace vulkan {
 namespace details {
 
+// one frame-in-flight copy of a uniform block
 template<typename UBO>
-class SingleUniformBlock : public impl::UniformBlock<UBO>, public BufferHandle, public details::UniformBlockBase
+class SingleUniformBlock : public BufferHandle, public details::UniformBlockBase
 {
     static constexpr auto BufferSize = static_cast<uint32_t>(sizeof(UBO));
 
 public:
     static Ptr<SingleUniformBlock> create(impl::GlslShader& shader, const char* uniform_block_name, uint32_t binding) noexcept;
-    ~SingleUniformBlock();
 
-    void update() override;
-    UBO& get() override;
+    // writes the ranges of ubo that differ from what this copy holds, returns the bytes written
+    size_t upload(const UBO& ubo);
+    bool initialized() const { return initialized_; }
 
 private:
     SingleUniformBlock(const Window& window, VkBuffer buffer) noexcept;
 
-    static VkDescriptorSetLayoutBinding initDescriptorSetLayoutBinding(VkShaderStageFlagBits type, uint32_t binding);
-    static VkDescriptorSetLayoutCreateInfo initDescriptorSetLayoutCreateInfo(const VkDescriptorSetLayoutBinding& dslb);
-
 private:
-    VkDescriptorSetLayout descriptor_set_layout_;
-    UBO ubo_;
+    UBO  uploaded_;
+    bool initialized_ = false;
 };
 
 } // namespace details
@@ -46,8 +44,8 @@ private:
     UniformBlock(GlslShader& shader, const char* uniform_block_name, uint32_t binding, uint32_t blocks_count) noexcept;
 
 private:
-    const uint32_t blocks_count_  = 1;
-    uint32_t       current_block_ = 0;
+    const uint32_t blocks_count_ = 1;
+    UBO            ubo_;
     std::vector<Ptr<details::SingleUniformBlock<UBO>>> uniform_blocks_;
 };
 
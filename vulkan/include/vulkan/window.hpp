@@ -2,7 +2,11 @@
 #define VULKAN_WINDOW_HPP
 
 #include "application.hpp"
+#include "descriptor_allocator.hpp"
 #include "framework.hpp"
+#include "gpu_profiler.hpp"
+#include "pipeline_library.hpp"
+#include "spirv_cache.hpp"
 
 namespace vulkan {
 
@@ -17,6 +21,7 @@ class Window : public impl::Window
     friend class Application;
     friend class BufferHandle;
     friend class CommandQueue;
+    friend class ComputePipeline;
     friend class GlslShader;
     friend class Pipeline;
 
@@ -25,9 +30,13 @@ public:
     DLL_EXPORT ~Window();
 
     DLL_EXPORT void swapFramebuffers(impl::CommandQueue& queue) override;
+    DLL_EXPORT const impl::GpuProfiler* gpuProfiler() const override { return gpu_profiler_.get(); }
+    DLL_EXPORT void printMemoryBudget(std::ostream& out) const override;
+    // the frame slot the next swapFramebuffers records and submits
+    uint32_t currentFrame() const { return current_frame_; }
 
 private:
-    Window(uint32_t frame_count, uint32_t width, uint32_t height, std::string_view title) noexcept;
+    Window(uint32_t frame_count, uint32_t width, uint32_t height, std::string_view title, bool headless) noexcept;
 
     void setInstance(VkInstance instance);
     bool createSurface(const Application& application);
@@ -35,11 +44,25 @@ private:
     bool createSwapchain(const Application& application);
     bool createSyncObjects(const Application& application);
 
+    // surface and swapchain extensions, left out when headless
+    static bool isPresentationExtension(std::string_view name);
+
     static Opt<std::vector<VkPhysicalDevice>> getPhysicalDevices(VkInstance instance);
     static Opt<VkPhysicalDevice> choosePhysicalDevice(const std::vector<VkPhysicalDevice>& devices);
 
     Opt<std::vector<std::string>> getAvailablePhysicalDeviceExtensionNames();
     bool checkPhysicalDeviceExtensions(const std::vector<std::string>& extensions);
+    Opt<VkPhysicalDeviceDescriptorIndexingFeaturesEXT> getDescriptorIndexingFeatures();
+    Opt<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT> getGraphicsPipelineLibraryFeatures();
+    Opt<uint32_t> getBindlessDescriptorCount();
+    uint32_t getUpdateAfterBindDescriptorLimit();
+
+    // one cache for every pipeline, vkCreateGraphicsPipelines may use it from several threads at once
+    bool createPipelineCache();
+    // empty when there is no cache on disk or it was written for another device
+    std::vector<char> loadPipelineCache() const;
+    bool savePipelineCache() const;
+    static VkPipelineCacheCreateInfo initPipelineCacheCreateInfo(const std::vector<char>& initial_data);
 
     std::vector<VkQueueFamilyProperties> getQueueFamilyProperties();
     static VkDeviceQueueCreateInfo initDeviceQueueCreateInfo(
@@ -65,21 +88,32 @@ private:
         , const std::vector<uint32_t>&    queue_family_indices);
 
     VkSubmitInfo initSubmitInfo(
-          VkSemaphore&                image_available_semaphore
-        , VkSemaphore&                render_finished_semaphore
+          VkSemaphore*                image_available_semaphore
+        , VkSemaphore*                render_finished_semaphore
         , const VkPipelineStageFlags& wait_dst_stage_mask
         , const VkCommandBuffer&      command_buffer);
     VkPresentInfoKHR initPresentInfo(VkSemaphore& render_finished_semaphore, uint32_t& image_index);
 
 private:
     const uint32_t   frame_count_;
+    uint32_t         current_frame_ = 0; // the slot the next swapFramebuffers records and submits
     VkInstance       instance_;
-    VkSurfaceKHR     surface_;
+    VkSurfaceKHR     surface_ = VK_NULL_HANDLE;
     VkPhysicalDevice physical_device_;
     VkDevice         device_;
-    VkSwapchainKHR   swapchain_;
+    VkSwapchainKHR   swapchain_ = VK_NULL_HANDLE;
     QueueInfo        graphic_queue_info_;
     QueueInfo        present_queue_info_;
+    uint32_t         bindless_descriptor_count_ = 0;
+    bool             memory_budget_ = false; // VK_EXT_memory_budget
+
+    Ptr<DescriptorAllocator> descriptor_allocator_;
+    Ptr<details::SpirvCache> spirv_cache_;
+    std::filesystem::path    pipeline_cache_path_;
+    VkPipelineCache          pipeline_cache_ = VK_NULL_HANDLE;
+    bool                     pipeline_cache_warm_ = false;
+    Ptr<details::PipelineLibraryCache> pipeline_libraries_; // null without VK_EXT_graphics_pipeline_library
+    Ptr<details::GpuProfiler>          gpu_profiler_;       // null unless gpu_profiler is set and the device can query
 
     std::vector<VkSemaphore> image_available_semaphores_;
     std::vector<VkSemaphore> render_finished_semaphores_;
@@ -1,5 +1,7 @@
 #include <glfw/glfw3.h>
 
+#include "startup_profile.hpp"
+
 #include "vulkan/application.hpp"
 #include "vulkan/debug_info.hpp"
 #include "vulkan/renderer.hpp"
@@ -10,27 +12,46 @@ namespace vulkan {
 DLL_EXPORT Ptr<Application> Application::create() noexcept
 {
     auto application = Ptr<Application>{ new Application{} };
+    auto& window = dynamic_cast<Window&>(Renderer::getWindow());
 
-    VkApplicationInfo ai = initApplicationInfo();
-    const auto inst_layers = Config::instance().get<std::vector, std::string>("vk_instance_layers");
-    if (!inst_layers || !checkInstanceLayers(*inst_layers)) {
-        return util::handle_error();
-    }
-    const auto inst_exts = Config::instance().get<std::vector, std::string>("vk_instance_extensions");
-    if (!inst_layers || !checkInstanceExtensions(*inst_exts)) {
-        return util::handle_error();
+    auto& profile = StartupProfile::instance();
+    {
+        const auto stage = profile.stage("instance");
+        VkApplicationInfo ai = initApplicationInfo();
+        const auto inst_layers = Config::instance().get<std::vector, std::string>("vk_instance_layers");
+        if (!inst_layers || !checkInstanceLayers(*inst_layers)) {
+            return util::handle_error();
+        }
+        auto inst_exts = Config::instance().get<std::vector, std::string>("vk_instance_extensions");
+        if (inst_exts && window.headless()) {
+            std::erase_if(*inst_exts, Window::isPresentationExtension);
+        }
+        if (!inst_exts || !checkInstanceExtensions(*inst_exts, window.headless())) {
+            return util::handle_error();
+        }
+        const auto layers = util::transform_each<const char*>(*inst_layers, util::string_cstr<char>);
+        const auto exts = util::transform_each<const char*>(*inst_exts, util::string_cstr<char>);
+        application->instance_create_info_ = initInstanceCreateInfo(ai, application->debug_utils_messenger_create_info_, layers, exts);
+        VULKAN_IF_ERROR_RETURN(vkCreateInstance(&application->instance_create_info_, nullptr, &application->instance_));
     }
-    const auto layers = util::transform_each<const char*>(*inst_layers, util::string_cstr<char>);
-    const auto exts = util::transform_each<const char*>(*inst_exts, util::string_cstr<char>);
-    application->instance_create_info_ = initInstanceCreateInfo(ai, application->debug_utils_messenger_create_info_, layers, exts);
-    VULKAN_IF_ERROR_RETURN(vkCreateInstance(&application->instance_create_info_, nullptr, &application->instance_));
 
-    auto& window = dynamic_cast<Window&>(Renderer::getWindow());
     window.setInstance(application->instance_);
-    window.createSurface(*application);
-    window.createDevice(*application);
-    window.createSwapchain(*application);
-    window.createSyncObjects(*application);
+    {
+        const auto stage = profile.stage("surface");
+        window.createSurface(*application);
+    }
+    {
+        const auto stage = profile.stage("device");
+        window.createDevice(*application);
+    }
+    {
+        const auto stage = profile.stage("swapchain");
+        window.createSwapchain(*application);
+    }
+    {
+        const auto stage = profile.stage("sync objects");
+        window.createSyncObjects(*application);
+    }
     return application;
 }
 
@@ -103,10 +124,11 @@ Opt<std::vector<std::string>> Application::getAvailableInstanceExtensionsNames()
     return extensions;
 }
 
-bool Application::checkInstanceExtensions(const std::vector<std::string>& extensions)
+bool Application::checkInstanceExtensions(const std::vector<std::string>& extensions, bool headless)
 {
     const auto available_extensions = getAvailableInstanceExtensionsNames();
-    const auto required_extensions = getRequiredInstanceExtensionNames();
+    // nothing is presented, GLFW is not even initialized
+    const auto required_extensions = headless ? std::vector<std::string>{} : getRequiredInstanceExtensionNames();
     if (!available_extensions.has_value() || !required_extensions.has_value()) {
         return util::handle_error();
     }
@@ -28,7 +28,7 @@ BufferHandle::~BufferHandle()
     }
 }
 
-bool BufferHandle::initBufferBase()
+bool BufferHandle::initBufferBase(MemoryStats::Category category)
 {
     Opt<VkMemoryAllocateInfo> mai = initMemoryAllocateInfo();
     if (!mai) {
@@ -36,6 +36,7 @@ bool BufferHandle::initBufferBase()
     }
 
     VULKAN_IF_ERROR_RETURN(vkAllocateMemory(device_, &mai.value(), nullptr, &device_memory_));
+    device_allocation_ = { MemoryStats::Heap::Device, category, mai->allocationSize };
     VULKAN_IF_ERROR_RETURN(vkBindBufferMemory(device_, buffer_, device_memory_, 0));
     VULKAN_IF_ERROR_RETURN(vkMapMemory(device_, device_memory_, 0, size_, 0, &mapped_));
     return true;
@@ -103,7 +104,8 @@ DLL_EXPORT Ptr<Buffer<T>> Buffer<T>::create(BufferUsage usage, const typename im
     }
 
     auto buffer = Ptr<Buffer>{ new Buffer{ window, *buf, items } };
-    if (!buffer->initBufferBase()) {
+    const auto category = usage == BufferUsage::Storage ? MemoryStats::Category::Uniforms : MemoryStats::Category::Geometry;
+    if (!buffer->initBufferBase(category)) {
         return util::handle_error();
     }
     std::memcpy(buffer->mapped_, buffer->storage_.data(), buffer_size);
@@ -118,5 +120,6 @@ Buffer<T>::Buffer(const Window& window, VkBuffer buffer, const typename impl::Bu
 
 template class Buffer<Vertex>;
 template class Buffer<uint32_t>;
+template class Buffer<ObjectData>;
 
 } // namespace vulkan
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include <ranges>
 
+#include "constants.h"
+#include "startup_profile.hpp"
+#include "trace.hpp"
+
 #include "vulkan/buffer.hpp"
 #include "vulkan/command_queue.hpp"
 #include "vulkan/renderer.hpp"
@@ -8,14 +12,19 @@
 namespace vulkan {
 namespace details {
 
-Ptr<DepthImage> DepthImage::create(VkPhysicalDevice physical_device, VkDevice device) noexcept
+Ptr<AttachmentImage> AttachmentImage::create(
+      VkPhysicalDevice   physical_device
+    , VkDevice           device
+    , VkFormat           format
+    , VkImageUsageFlags  usage
+    , VkImageAspectFlags aspect) noexcept
 {
     const auto width = *Config::instance().get<uint32_t>("width");
     const auto height = *Config::instance().get<uint32_t>("height");
 
-    Ptr<DepthImage> image{ new DepthImage{physical_device, device} };
+    Ptr<AttachmentImage> image{ new AttachmentImage{physical_device, device, format, aspect} };
 
-    VkImageCreateInfo ici = initImageCreateInfo(width, height);
+    VkImageCreateInfo ici = initImageCreateInfo(width, height, format, usage);
     VULKAN_IF_ERROR_RETURN(vkCreateImage(image->device_, &ici, nullptr, &image->image_));
 
     VkMemoryRequirements mem_requirements;
@@ -26,6 +35,7 @@ Ptr<DepthImage> DepthImage::create(VkPhysicalDevice physical_device, VkDevice de
     mai.allocationSize  = mem_requirements.size;
     mai.memoryTypeIndex = *image->findMemoryType(mem_requirements.memoryTypeBits);
     VULKAN_IF_ERROR_RETURN(vkAllocateMemory(image->device_, &mai, nullptr, &image->image_memory_));
+    image->image_allocation_ = { MemoryStats::Heap::Device, MemoryStats::Category::Images, mai.allocationSize };
     VULKAN_IF_ERROR_RETURN(vkBindImageMemory(image->device_, image->image_, image->image_memory_, 0));
 
     VkImageViewCreateInfo ivci = image->initImageViewCreateInfo();
@@ -33,7 +43,7 @@ Ptr<DepthImage> DepthImage::create(VkPhysicalDevice physical_device, VkDevice de
     return image;
 }
 
-DepthImage::~DepthImage()
+AttachmentImage::~AttachmentImage()
 {
     if (!device_) {
         return;
@@ -49,12 +59,14 @@ DepthImage::~DepthImage()
     }
 }
 
-DepthImage::DepthImage(VkPhysicalDevice physical_device, VkDevice device) noexcept
+AttachmentImage::AttachmentImage(VkPhysicalDevice physical_device, VkDevice device, VkFormat format, VkImageAspectFlags aspect) noexcept
     : physical_device_{ physical_device }
     , device_{ device }
+    , format_{ format }
+    , aspect_{ aspect }
 {}
 
-VkImageCreateInfo DepthImage::initImageCreateInfo(uint32_t width, uint32_t height)
+VkImageCreateInfo AttachmentImage::initImageCreateInfo(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage)
 {
     VkImageCreateInfo ici{};
     ici.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -64,16 +76,16 @@ VkImageCreateInfo DepthImage::initImageCreateInfo(uint32_t width, uint32_t heigh
     ici.extent.depth  = 1;
     ici.mipLevels     = 1;
     ici.arrayLayers   = 1;
-    ici.format        = VK_FORMAT_D32_SFLOAT;
+    ici.format        = format;
     ici.tiling        = VK_IMAGE_TILING_OPTIMAL;
     ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    ici.usage         = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    ici.usage         = usage;
     ici.samples       = VK_SAMPLE_COUNT_1_BIT;
     ici.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
     return ici;
 }
 
-std::optional<uint32_t> DepthImage::findMemoryType(uint32_t type_filter)
+std::optional<uint32_t> AttachmentImage::findMemoryType(uint32_t type_filter)
 {
     VkPhysicalDeviceMemoryProperties mem_properties;
     vkGetPhysicalDeviceMemoryProperties(physical_device_, &mem_properties);
@@ -88,14 +100,14 @@ std::optional<uint32_t> DepthImage::findMemoryType(uint32_t type_filter)
     return std::nullopt;
 }
 
-VkImageViewCreateInfo DepthImage::initImageViewCreateInfo()
+VkImageViewCreateInfo AttachmentImage::initImageViewCreateInfo()
 {
     VkImageViewCreateInfo view_info{};
     view_info.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     view_info.image                           = image_;
     view_info.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
-    view_info.format                          = VK_FORMAT_D32_SFLOAT;
-    view_info.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_DEPTH_BIT;
+    view_info.format                          = format_;
+    view_info.subresourceRange.aspectMask     = aspect_;
     view_info.subresourceRange.baseMipLevel   = 0;
     view_info.subresourceRange.levelCount     = 1;
     view_info.subresourceRange.baseArrayLayer = 0;
@@ -108,27 +120,19 @@ VkImageViewCreateInfo DepthImage::initImageViewCreateInfo()
 DLL_EXPORT Ptr<CommandQueue> CommandQueue::create(const impl::Pipeline& pipeline) noexcept
 {
     const auto& pline = dynamic_cast<const Pipeline&>(pipeline);
-    Ptr<CommandQueue> queue{ new CommandQueue{pline.device_, pline.pipeline_layout_} };
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    Ptr<CommandQueue> queue{ new CommandQueue{pline.device_, pline.pipeline_layout_, window.bindless_descriptor_count_} };
 
     queue->render_pass_ = pline.render_pass_->get();
     queue->pipeline_ = pline.pipeline_;
+    queue->gpu_profiler_ = window.gpu_profiler_.get();
 
-    uint32_t ubos_count = static_cast<uint32_t>(pline.uniform_buffers_.size());
-    VkDescriptorPoolSize descriptor_pool_size = { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, ubos_count };
-    VkDescriptorPoolCreateInfo dpci = initDescriptorPoolCreateInfo(descriptor_pool_size);
-    VULKAN_IF_ERROR_RETURN(vkCreateDescriptorPool(queue->device_, &dpci, nullptr, &queue->descriptor_pool_));
-
-    VkDescriptorSetAllocateInfo dsai = queue->initDescriptorSetAllocateInfo(pline.descriptor_set_layouts_);
-    queue->descriptor_sets_.resize(ubos_count);
-    VULKAN_IF_ERROR_RETURN(vkAllocateDescriptorSets(queue->device_, &dsai, &queue->descriptor_sets_[0]));
-
-    for (auto i = 0; i != ubos_count; ++i) {
-        const auto& [buffer, size] = pline.uniform_buffers_[i];
-        VkDescriptorBufferInfo dbi = initDescriptorBufferInfo(buffer, size);
-        VkWriteDescriptorSet wds = infoWriteDescriptorSet(queue->descriptor_sets_[i], dbi);
-        vkUpdateDescriptorSets(queue->device_, 1, &wds, 0, nullptr);
-    }
+    // the frame's descriptor set is allocated and written when its command buffer is recorded
+    queue->descriptor_set_layout_ = pline.descriptor_set_layout_;
+    queue->uniform_buffers_ = pline.uniform_buffers_;
 
+    auto& profile = StartupProfile::instance();
+    const auto framebuffer_stage = profile.stage("framebuffers");
     const auto framebuffer_count = Config::instance().get<uint32_t>("vk_framebuffers");
     const auto surface_format = Config::instance().get<std::underlying_type_t<VkFormat>>("vk_surface_format");
     const auto width = Config::instance().get<uint32_t>("width");
@@ -138,25 +142,50 @@ DLL_EXPORT Ptr<CommandQueue> CommandQueue::create(const impl::Pipeline& pipeline
     }
     const auto format = static_cast<VkFormat>(*surface_format);
 
-    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
-    const auto images = queue->getSwapchainImages(window.swapchain_);
-    if (!images || images->size() < *framebuffer_count) {
-        return util::handle_error();
+    std::vector<VkImageView> color_views{};
+    if (window.headless()) {
+        for (auto i = 0; i != *framebuffer_count; ++i) {
+            auto image = details::AttachmentImage::create(
+                  window.physical_device_
+                , window.device_
+                , format
+                , VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                , VK_IMAGE_ASPECT_COLOR_BIT
+            );
+            if (!image) {
+                return util::handle_error();
+            }
+            color_views.push_back(image->image_view_);
+            queue->color_images_.push_back(std::move(image));
+        }
     }
+    else {
+        const auto images = queue->getSwapchainImages(window.swapchain_);
+        if (!images || images->size() < *framebuffer_count) {
+            return util::handle_error();
+        }
 
-    queue->image_views_.resize(images->size());
-    for (auto i = 0; i != images->size(); ++i) {
-        const auto& image = images->at(i);
-        auto& image_view = queue->image_views_[i];
-        VkImageViewCreateInfo ivci = initImageViewCreateInfo(image, format);
-        VULKAN_IF_ERROR_RETURN(vkCreateImageView(queue->device_, &ivci, nullptr, &image_view));
+        queue->image_views_.resize(images->size());
+        for (auto i = 0; i != images->size(); ++i) {
+            const auto& image = images->at(i);
+            auto& image_view = queue->image_views_[i];
+            VkImageViewCreateInfo ivci = initImageViewCreateInfo(image, format);
+            VULKAN_IF_ERROR_RETURN(vkCreateImageView(queue->device_, &ivci, nullptr, &image_view));
+        }
+        color_views = queue->image_views_;
     }
 
-    queue->depth_image_ = std::move(details::DepthImage::create(window.physical_device_, window.device_));
+    queue->depth_image_ = details::AttachmentImage::create(
+          window.physical_device_
+        , window.device_
+        , VK_FORMAT_D32_SFLOAT
+        , VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+        , VK_IMAGE_ASPECT_DEPTH_BIT
+    );
     queue->framebuffers_.resize(*framebuffer_count);
-    assert(queue->framebuffers_.size() == queue->image_views_.size());
-    for (auto i = 0; i != images->size(); ++i) {
-        const auto& image_view = queue->image_views_[i];
+    assert(queue->framebuffers_.size() == color_views.size());
+    for (auto i = 0; i != color_views.size(); ++i) {
+        const auto& image_view = color_views[i];
         auto& fb = queue->framebuffers_[i];
         std::array<VkImageView, 2> attachments{ image_view, queue->depth_image_->image_view_ };
         VkFramebufferCreateInfo fbci = initFramebufferCreateInfo(pline.render_pass_->get(), attachments, *width, *height);
@@ -177,7 +206,8 @@ DLL_EXPORT CommandQueue::~CommandQueue()
     if (!device_) {
         return;
     }
-    if (descriptor_pool_) {
+    // the frame descriptor sets go back with the window's descriptor allocator
+    if (command_pool_) {
         vkFreeCommandBuffers(device_, command_pool_, static_cast<uint32_t>(command_buffers_.size()), &command_buffers_[0]);
         vkDestroyCommandPool(device_, command_pool_, nullptr);
         for (const auto& fb : framebuffers_) {
@@ -186,8 +216,6 @@ DLL_EXPORT CommandQueue::~CommandQueue()
         for (const auto& image_view : image_views_) {
             vkDestroyImageView(device_, image_view, nullptr);
         }
-        vkFreeDescriptorSets(device_, descriptor_pool_, static_cast<uint32_t>(descriptor_sets_.size()), descriptor_sets_.data());
-        vkDestroyDescriptorPool(device_, descriptor_pool_, nullptr);
     }
 }
 
@@ -196,26 +224,84 @@ DLL_EXPORT void CommandQueue::addCommand(impl::Command& command)
     commands_.push_back(&command);
 }
 
-CommandQueue::CommandQueue(VkDevice device, VkPipelineLayout pipeline_layout) noexcept
+DLL_EXPORT Opt<uint32_t> CommandQueue::addObjectBuffer(const BufferHandle& buffer)
+{
+    if (object_buffers_.size() == bindless_descriptor_count_) {
+        return util::handle_error() << "Bindless descriptor array is full";
+    }
+    // written into the frame descriptor set from the next recorded frame on
+    object_buffers_.push_back(initDescriptorBufferInfo(buffer.buffer_, buffer.size_));
+    return static_cast<uint32_t>(object_buffers_.size() - 1);
+}
+
+CommandQueue::CommandQueue(VkDevice device, VkPipelineLayout pipeline_layout, uint32_t bindless_descriptor_count) noexcept
     : device_{ device }
     , pipeline_layout_{ pipeline_layout }
+    , bindless_descriptor_count_{ bindless_descriptor_count }
 {}
 
 bool CommandQueue::recordCommandBuffer()
 {
+    TRACE_ZONE("CommandQueue::recordCommandBuffer");
+    if (!writeFrameDescriptorSet()) {
+        return util::handle_error();
+    }
     VULKAN_IF_ERROR_RETURN(vkResetCommandBuffer(command_buffers_[current_image_index_], 0));
 
     VkCommandBufferBeginInfo begin_info = initCommandBufferBeginInfo();
     VULKAN_IF_ERROR_RETURN(vkBeginCommandBuffer(command_buffers_[current_image_index_], &begin_info));
+    ++frame_stats_.command_buffers;
+    if (gpu_profiler_) {
+        gpu_profiler_->begin(command_buffers_[current_image_index_], current_frame_);
+    }
+    render_pass_begun_ = false;
+    bound_pipeline_ = VK_NULL_HANDLE;
+    bound_descriptor_set_ = VK_NULL_HANDLE;
+    bound_geometry_ = nullptr;
+    sortCommands(commands_);
     for (auto& cmd : commands_) {
         (*cmd)(*this);
     }
+    // a queue without a ClearCommand never begins the render pass
+    if (render_pass_begun_) {
+        vkCmdEndRenderPass(command_buffers_[current_image_index_]);
+    }
+    if (gpu_profiler_) {
+        gpu_profiler_->end(command_buffers_[current_image_index_], current_frame_);
+    }
     VULKAN_IF_ERROR_RETURN(vkEndCommandBuffer(command_buffers_[current_image_index_]));
     return true;
 }
 
+bool CommandQueue::writeFrameDescriptorSet()
+{
+    // the window has reset the pools of this frame slot, so last time's set is gone and a fresh one costs no fragmentation
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    const auto descriptor_set = window.descriptor_allocator_->allocateTransient(descriptor_set_layout_);
+    if (!descriptor_set) {
+        return util::handle_error();
+    }
+    frame_descriptor_set_ = *descriptor_set;
+
+    std::vector<VkWriteDescriptorSet> writes{};
+    VkDescriptorBufferInfo uniform_buffer{};
+    if (current_frame_ < uniform_buffers_.size()) {
+        // UniformBlock::update writes the copy of the current frame slot
+        const auto& [buffer, size, binding, stage] = uniform_buffers_[current_frame_];
+        uniform_buffer = initDescriptorBufferInfo(buffer, size);
+        writes.push_back(infoWriteDescriptorSet(frame_descriptor_set_, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, binding, 0, uniform_buffer));
+    }
+    if (!object_buffers_.empty()) {
+        auto& wds = writes.emplace_back(infoWriteDescriptorSet(frame_descriptor_set_, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, DRAW_DATA_BINDING, 0, object_buffers_.front()));
+        wds.descriptorCount = static_cast<uint32_t>(object_buffers_.size());
+    }
+    vkUpdateDescriptorSets(device_, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    return true;
+}
+
 void CommandQueue::acquireNextImage(VkSemaphore image_available_semaphore)
 {
+    TRACE_ZONE("CommandQueue::acquireNextImage");
     const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
     constexpr auto render_timeout = std::numeric_limits<uint64_t>::max();
     VULKAN_IF_ERROR_RETURN_VOID(vkAcquireNextImageKHR(
@@ -228,29 +314,6 @@ void CommandQueue::acquireNextImage(VkSemaphore image_available_semaphore)
     ));
 }
 
-VkDescriptorPoolCreateInfo CommandQueue::initDescriptorPoolCreateInfo(const VkDescriptorPoolSize& size)
-{
-    VkDescriptorPoolCreateInfo dpci = {};
-    dpci.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    dpci.pNext         = nullptr;
-    dpci.flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    dpci.maxSets       = *Config::instance().get<uint32_t>("vk_framebuffers"); //2;
-    dpci.poolSizeCount = 1;
-    dpci.pPoolSizes    = &size;
-    return dpci;
-}
-
-VkDescriptorSetAllocateInfo CommandQueue::initDescriptorSetAllocateInfo(const std::vector<VkDescriptorSetLayout>& layouts)
-{
-    VkDescriptorSetAllocateInfo dsai = {};
-    dsai.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    dsai.pNext              = nullptr;
-    dsai.descriptorPool     = descriptor_pool_;
-    dsai.descriptorSetCount = static_cast<uint32_t>(layouts.size());
-    dsai.pSetLayouts        = layouts.data();
-    return dsai;
-}
-
 VkDescriptorBufferInfo CommandQueue::initDescriptorBufferInfo(VkBuffer buffer, VkDeviceSize ubo_size)
 {
     VkDescriptorBufferInfo dbi = {};
@@ -260,16 +323,21 @@ VkDescriptorBufferInfo CommandQueue::initDescriptorBufferInfo(VkBuffer buffer, V
     return dbi;
 }
 
-VkWriteDescriptorSet CommandQueue::infoWriteDescriptorSet(VkDescriptorSet descriptor_set, const VkDescriptorBufferInfo& dbi)
+VkWriteDescriptorSet CommandQueue::infoWriteDescriptorSet(
+      VkDescriptorSet               descriptor_set
+    , VkDescriptorType              type
+    , uint32_t                      binding
+    , uint32_t                      array_element
+    , const VkDescriptorBufferInfo& dbi)
 {
     VkWriteDescriptorSet wds = {};
     wds.sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     wds.pNext            = nullptr;
     wds.dstSet           = descriptor_set;
-    wds.dstBinding       = 0;
-    wds.dstArrayElement  = 0;
+    wds.dstBinding       = binding;
+    wds.dstArrayElement  = array_element;
     wds.descriptorCount  = 1;
-    wds.descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    wds.descriptorType   = type;
     wds.pImageInfo       = nullptr;
     wds.pBufferInfo      = &dbi;
     wds.pTexelBufferView = nullptr;
@@ -387,7 +455,11 @@ DLL_EXPORT void ClearCommand::operator()(impl::CommandQueue& queue)
     clear_values[0].color = { clear_color[0], clear_color[1], clear_color[2], clear_color[3] };
     clear_values[1].depthStencil = { 1.0f, 0 };
     VkRenderPassBeginInfo rpbi = initRenderPassBeginInfo(q.render_pass_, q.framebuffers_[q.current_image_index_], VkRect2D{ {0, 0}, extent_ }, clear_values);
+    if (q.gpu_profiler_) {
+        q.gpu_profiler_->beginRenderPass(q.command_buffers_[q.current_image_index_], q.current_frame_);
+    }
     vkCmdBeginRenderPass(q.command_buffers_[q.current_image_index_], &rpbi, VK_SUBPASS_CONTENTS_INLINE);
+    q.render_pass_begun_ = true;
 }
 
 ClearCommand::ClearCommand(VkExtent2D extent) noexcept
@@ -411,38 +483,108 @@ VkRenderPassBeginInfo ClearCommand::initRenderPassBeginInfo(
     return rpbi;
 }
 
-DLL_EXPORT Ptr<DrawCommand> DrawCommand::create(const impl::BufferHandle& vertex_buffer, const impl::BufferHandle& index_buffer) noexcept
+DLL_EXPORT Ptr<DispatchCommand> DispatchCommand::create(const impl::ComputePipeline& pipeline, uint32_t x, uint32_t y, uint32_t z) noexcept
 {
-    const auto& vb = dynamic_cast<const BufferHandle&>(vertex_buffer);
-    const auto& ib = dynamic_cast<const BufferHandle&>(index_buffer);
-    Ptr<DrawCommand> cmd{ new DrawCommand{vb, ib} };
-    return cmd;
+    return Ptr<DispatchCommand>{ new DispatchCommand{ dynamic_cast<const ComputePipeline&>(pipeline), x, y, z } };
 }
 
-DLL_EXPORT void DrawCommand::operator()(impl::CommandQueue& queue)
+DLL_EXPORT void DispatchCommand::operator()(impl::CommandQueue& queue)
 {
     auto& q = dynamic_cast<CommandQueue&>(queue);
-    vkCmdBindPipeline(q.command_buffers_[q.current_image_index_], VK_PIPELINE_BIND_POINT_GRAPHICS, q.pipeline_);
-
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(q.command_buffers_[q.current_image_index_], 0, 1, &vertex_buffer_.buffer_, &offset);
-    vkCmdBindIndexBuffer(q.command_buffers_[q.current_image_index_], index_buffer_.buffer_, offset, VK_INDEX_TYPE_UINT32);
-    vkCmdBindDescriptorSets(
-          q.command_buffers_[q.current_image_index_]
-        , VK_PIPELINE_BIND_POINT_GRAPHICS
-        , q.pipeline_layout_
+    if (q.render_pass_begun_) {
+        IGNORE(util::handle_error() << "Dispatch recorded inside the render pass, add it before the clear command");
+        return;
+    }
+    // the compute bind point has its own state, graphics bindings stay valid
+    const auto command_buffer = q.command_buffers_[q.current_image_index_];
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_.pipeline_);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_.pipeline_layout_, 0, 1, &pipeline_.descriptor_set_, 0, nullptr);
+    ++q.frame_stats_.pipeline_binds;
+    ++q.frame_stats_.descriptor_binds;
+    vkCmdDispatch(command_buffer, x_, y_, z_);
+
+    // results become visible to later dispatches and to everything draws read
+    VkMemoryBarrier mb = initMemoryBarrier();
+    vkCmdPipelineBarrier(
+          command_buffer
+        , VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+        , VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+            | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT
+            | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+            | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT
+            | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
         , 0
-        , 1 // current frame
-        , &q.descriptor_sets_[0]
+        , 1, &mb
+        , 0, nullptr
         , 0, nullptr
     );
-    vkCmdDrawIndexed(q.command_buffers_[q.current_image_index_], index_buffer_.elem_count_, 1, 0, 0, 0);
-    vkCmdEndRenderPass(q.command_buffers_[q.current_image_index_]);
 }
 
-DrawCommand::DrawCommand(const BufferHandle& vertex_buffer, const BufferHandle& index_buffer) noexcept
-    : vertex_buffer_{ vertex_buffer }
-    , index_buffer_{ index_buffer }
+DispatchCommand::DispatchCommand(const ComputePipeline& pipeline, uint32_t x, uint32_t y, uint32_t z) noexcept
+    : pipeline_{ pipeline }
+    , x_{ x }
+    , y_{ y }
+    , z_{ z }
+{}
+
+VkMemoryBarrier DispatchCommand::initMemoryBarrier()
+{
+    VkMemoryBarrier mb = {};
+    mb.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    mb.pNext         = nullptr;
+    mb.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT
+                     | VK_ACCESS_SHADER_WRITE_BIT
+                     | VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+                     | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+                     | VK_ACCESS_INDEX_READ_BIT
+                     | VK_ACCESS_UNIFORM_READ_BIT;
+    return mb;
+}
+
+DLL_EXPORT Ptr<DrawCommand> DrawCommand::create(
+      const impl::Pipeline&           pipeline
+    , const impl::GeometryPoolHandle& geometry
+    , const impl::GeometryRange&      range) noexcept
+{
+    const auto& pline = dynamic_cast<const Pipeline&>(pipeline);
+    const auto& pool = dynamic_cast<const GeometryPoolHandle&>(geometry);
+    Ptr<DrawCommand> cmd{ new DrawCommand{pline, pool, range} };
+    return cmd;
+}
+
+DLL_EXPORT void DrawCommand::operator()(impl::CommandQueue& queue)
+{
+    auto& q = dynamic_cast<CommandQueue&>(queue);
+    const auto command_buffer = q.command_buffers_[q.current_image_index_];
+    if (q.changeState(q.bound_pipeline_, pipeline_.current(), &impl::FrameStats::pipeline_binds)) {
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, q.bound_pipeline_);
+    }
+    if (q.changeState(q.bound_geometry_, &geometry_, &impl::FrameStats::buffer_binds)) {
+        geometry_.bind(command_buffer);
+    }
+    if (q.changeState(q.bound_descriptor_set_, q.frame_descriptor_set_, &impl::FrameStats::descriptor_binds)) {
+        vkCmdBindDescriptorSets(
+              command_buffer
+            , VK_PIPELINE_BIND_POINT_GRAPHICS
+            , pipeline_.pipeline_layout_
+            , 0
+            , 1
+            , &q.frame_descriptor_set_
+            , 0, nullptr
+        );
+    }
+    const DrawConstants constants{ draw_data_.mvp, draw_index_ };
+    vkCmdPushConstants(command_buffer, pipeline_.pipeline_layout_, Pipeline::DrawConstantsRange.stageFlags, 0, sizeof(constants), &constants);
+    vkCmdDrawIndexed(command_buffer, range_.index_count, 1, range_.first_index, range_.vertex_offset, 0);
+    q.countDraw(range_.index_count);
+}
+
+DrawCommand::DrawCommand(const Pipeline& pipeline, const GeometryPoolHandle& geometry, const impl::GeometryRange& range) noexcept
+    : impl::DrawCommand{ pipeline, geometry }
+    , pipeline_{ pipeline }
+    , geometry_{ geometry }
+    , range_{ range }
 {}
 
 } // namespace vulkan
\ No newline at end of file
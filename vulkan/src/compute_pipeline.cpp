@@ -0,0 +1,125 @@
+#include "vulkan/compute_pipeline.hpp"
+#include "vulkan/renderer.hpp"
+#include "vulkan/window.hpp"
+
+namespace vulkan {
+
+DLL_EXPORT Ptr<ComputePipeline> ComputePipeline::create() noexcept
+{
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    return Ptr<ComputePipeline>{ new ComputePipeline{ window.device_, window.pipeline_cache_ } };
+}
+
+DLL_EXPORT ComputePipeline::~ComputePipeline() noexcept
+{
+    if (!device_) {
+        return;
+    }
+    if (pipeline_) {
+        vkDestroyPipeline(device_, pipeline_, nullptr);
+    }
+    if (pipeline_layout_) {
+        vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
+    }
+}
+
+DLL_EXPORT void ComputePipeline::setShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants)
+{
+    shader_ = &dynamic_cast<const GlslShader&>(shader);
+    specialization_ = details::Specialization::create(constants);
+}
+
+DLL_EXPORT void ComputePipeline::addStorageBuffer(uint32_t binding, const impl::BufferHandle& buffer)
+{
+    const auto& buf = dynamic_cast<const BufferHandle&>(buffer);
+    storage_buffers_.emplace_back(binding, VkDescriptorBufferInfo{ buf.buffer_, 0, buf.size_ });
+}
+
+DLL_EXPORT bool ComputePipeline::use()
+{
+    if (!shader_ || shader_->type_ != VK_SHADER_STAGE_COMPUTE_BIT) {
+        return util::handle_error() << "Compute pipeline needs a compute shader";
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings{};
+    for (const auto& [binding, dbi] : storage_buffers_) {
+        bindings.push_back(Pipeline::initDescriptorSetLayoutBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, binding, VK_SHADER_STAGE_COMPUTE_BIT, 1));
+    }
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    auto descriptor_set_layout = window.descriptor_allocator_->getLayout(bindings, std::vector<VkDescriptorBindingFlagsEXT>(bindings.size(), 0));
+    if (!descriptor_set_layout) {
+        return util::handle_error();
+    }
+    descriptor_set_layout_ = std::move(*descriptor_set_layout);
+
+    const auto descriptor_set = window.descriptor_allocator_->allocate(descriptor_set_layout_);
+    if (!descriptor_set) {
+        return util::handle_error();
+    }
+    descriptor_set_ = *descriptor_set;
+    for (const auto& [binding, dbi] : storage_buffers_) {
+        VkWriteDescriptorSet wds = initWriteDescriptorSet(descriptor_set_, binding, dbi);
+        vkUpdateDescriptorSets(device_, 1, &wds, 0, nullptr);
+    }
+
+    VkPipelineLayoutCreateInfo plci = initPipelineLayoutCreateInfo();
+    VULKAN_IF_ERROR_RETURN(vkCreatePipelineLayout(device_, &plci, nullptr, &pipeline_layout_));
+
+    const auto pssci = Pipeline::initPipelineShaderStageCreateInfo(
+          shader_->shader_
+        , VK_SHADER_STAGE_COMPUTE_BIT
+        , specialization_ ? &specialization_->info : nullptr
+    );
+    VkComputePipelineCreateInfo cpci = initComputePipelineCreateInfo(pssci);
+    VULKAN_IF_ERROR_RETURN(vkCreateComputePipelines(device_, pipeline_cache_, 1, &cpci, nullptr, &pipeline_));
+    return true;
+}
+
+ComputePipeline::ComputePipeline(VkDevice device, VkPipelineCache pipeline_cache) noexcept
+    : device_{ device }
+    , pipeline_cache_{ pipeline_cache }
+{}
+
+VkWriteDescriptorSet ComputePipeline::initWriteDescriptorSet(VkDescriptorSet descriptor_set, uint32_t binding, const VkDescriptorBufferInfo& dbi)
+{
+    VkWriteDescriptorSet wds = {};
+    wds.sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    wds.pNext            = nullptr;
+    wds.dstSet           = descriptor_set;
+    wds.dstBinding       = binding;
+    wds.dstArrayElement  = 0;
+    wds.descriptorCount  = 1;
+    wds.descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    wds.pImageInfo       = nullptr;
+    wds.pBufferInfo      = &dbi;
+    wds.pTexelBufferView = nullptr;
+    return wds;
+}
+
+VkPipelineLayoutCreateInfo ComputePipeline::initPipelineLayoutCreateInfo()
+{
+    VkPipelineLayoutCreateInfo plci = {};
+    plci.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    plci.pNext                  = nullptr;
+    plci.flags                  = 0;
+    plci.setLayoutCount         = 1;
+    plci.pSetLayouts            = &descriptor_set_layout_.layout;
+    plci.pushConstantRangeCount = 0;
+    plci.pPushConstantRanges    = nullptr;
+    return plci;
+}
+
+VkComputePipelineCreateInfo ComputePipeline::initComputePipelineCreateInfo(const VkPipelineShaderStageCreateInfo& pssci)
+{
+    VkComputePipelineCreateInfo cpci = {};
+    cpci.sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    cpci.pNext              = nullptr;
+    cpci.flags              = 0;
+    cpci.stage              = pssci;
+    cpci.layout             = pipeline_layout_;
+    cpci.basePipelineHandle = VK_NULL_HANDLE;
+    cpci.basePipelineIndex  = 0;
+    return cpci;
+}
+
+} // namespace vulkan
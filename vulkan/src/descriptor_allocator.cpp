@@ -0,0 +1,272 @@
+#include "vulkan/descriptor_allocator.hpp"
+#include "vulkan/renderer.hpp"
+
+namespace vulkan {
+namespace details {
+
+DescriptorPoolChain::DescriptorPoolChain(VkDevice device, UpdateAfterBindBudget& update_after_bind_budget) noexcept
+    : device_{ device }
+    , update_after_bind_budget_{ update_after_bind_budget }
+{}
+
+DescriptorPoolChain::~DescriptorPoolChain()
+{
+    for (const auto& [layout, chain] : pools_) {
+        for (const auto& pool : chain.pools) {
+            vkDestroyDescriptorPool(device_, pool, nullptr);
+        }
+    }
+}
+
+Opt<VkDescriptorSet> DescriptorPoolChain::allocate(const DescriptorSetLayout& layout)
+{
+    auto& chain = pools_[layout.layout];
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    for (; chain.current != chain.pools.size(); ++chain.current) {
+        const auto result = allocateFrom(chain.pools[chain.current], layout, set);
+        if (result == VK_SUCCESS) {
+            return set;
+        }
+        // every set of the chain has the same size, a pool that cannot take one now never will
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+            return util::handle_error() << "VkResult = " << result;
+        }
+    }
+
+    const auto pool = createPool(layout, chain);
+    if (!pool) {
+        return util::handle_error();
+    }
+    chain.pools.push_back(*pool);
+    VULKAN_IF_ERROR_RETURN(allocateFrom(*pool, layout, set));
+    return set;
+}
+
+bool DescriptorPoolChain::reset()
+{
+    for (auto& [layout, chain] : pools_) {
+        for (const auto& pool : chain.pools) {
+            VULKAN_IF_ERROR_RETURN(vkResetDescriptorPool(device_, pool, 0));
+        }
+        chain.current = 0;
+    }
+    return true;
+}
+
+VkResult DescriptorPoolChain::allocateFrom(VkDescriptorPool pool, const DescriptorSetLayout& layout, VkDescriptorSet& set)
+{
+    const auto dsvdcai = initDescriptorSetVariableDescriptorCountAllocateInfo(layout.variable_count);
+    VkDescriptorSetAllocateInfo dsai = initDescriptorSetAllocateInfo(pool, layout.layout, layout.variable_count ? &dsvdcai : nullptr);
+    return vkAllocateDescriptorSets(device_, &dsai, &set);
+}
+
+Opt<VkDescriptorPool> DescriptorPoolChain::createPool(const DescriptorSetLayout& layout, Pools& chain)
+{
+    uint32_t sets = chain.sets_per_pool;
+    uint32_t descriptors_per_set = 0;
+    for (const auto& size : layout.sizes) {
+        descriptors_per_set += size.descriptorCount;
+    }
+    // update-after-bind descriptors of all pools together must stay within the device limit
+    if (layout.update_after_bind && descriptors_per_set != 0) {
+        const auto& [limit, used] = update_after_bind_budget_;
+        sets = std::min(sets, (limit - used) / descriptors_per_set);
+        if (sets == 0) {
+            return util::handle_error() << "maxUpdateAfterBindDescriptorsInAllPools (" << limit << ") reached";
+        }
+    }
+
+    auto sizes = layout.sizes;
+    for (auto& size : sizes) {
+        size.descriptorCount *= sets;
+    }
+    VkDescriptorPoolCreateInfo dpci = initDescriptorPoolCreateInfo(sets, sizes, layout.update_after_bind);
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VULKAN_IF_ERROR_RETURN(vkCreateDescriptorPool(device_, &dpci, nullptr, &pool));
+    if (layout.update_after_bind) {
+        update_after_bind_budget_.used += sets * descriptors_per_set;
+    }
+    chain.sets_per_pool = std::min(chain.sets_per_pool * 2, MaxSetsPerPool);
+    return pool;
+}
+
+VkDescriptorPoolCreateInfo DescriptorPoolChain::initDescriptorPoolCreateInfo(
+      uint32_t                                 max_sets
+    , const std::vector<VkDescriptorPoolSize>& sizes
+    , bool                                     update_after_bind)
+{
+    VkDescriptorPoolCreateInfo dpci = {};
+    dpci.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    dpci.pNext         = nullptr;
+    dpci.flags         = update_after_bind ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT : 0;
+    dpci.maxSets       = max_sets;
+    dpci.poolSizeCount = static_cast<uint32_t>(sizes.size());
+    dpci.pPoolSizes    = sizes.data();
+    return dpci;
+}
+
+VkDescriptorSetVariableDescriptorCountAllocateInfoEXT DescriptorPoolChain::initDescriptorSetVariableDescriptorCountAllocateInfo(const uint32_t& count)
+{
+    VkDescriptorSetVariableDescriptorCountAllocateInfoEXT dsvdcai = {};
+    dsvdcai.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO_EXT;
+    dsvdcai.pNext              = nullptr;
+    dsvdcai.descriptorSetCount = 1;
+    dsvdcai.pDescriptorCounts  = &count;
+    return dsvdcai;
+}
+
+VkDescriptorSetAllocateInfo DescriptorPoolChain::initDescriptorSetAllocateInfo(
+      VkDescriptorPool                                             pool
+    , const VkDescriptorSetLayout&                                 layout
+    , const VkDescriptorSetVariableDescriptorCountAllocateInfoEXT* dsvdcai)
+{
+    VkDescriptorSetAllocateInfo dsai = {};
+    dsai.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    dsai.pNext              = dsvdcai;
+    dsai.descriptorPool     = pool;
+    dsai.descriptorSetCount = 1;
+    dsai.pSetLayouts        = &layout;
+    return dsai;
+}
+
+} // namespace details
+
+Ptr<DescriptorAllocator> DescriptorAllocator::create(VkDevice device, uint32_t frame_count, uint32_t update_after_bind_limit) noexcept
+{
+    auto allocator = Ptr<DescriptorAllocator>{ new DescriptorAllocator{ device, update_after_bind_limit } };
+    allocator->persistent_ = std::make_unique<details::DescriptorPoolChain>(device, allocator->update_after_bind_budget_);
+    for (uint32_t i = 0; i != frame_count; ++i) {
+        allocator->frames_.push_back(std::make_unique<details::DescriptorPoolChain>(device, allocator->update_after_bind_budget_));
+    }
+    return allocator;
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+    frames_.clear();
+    persistent_.reset();
+    for (const auto& [hash, layouts] : layouts_) {
+        for (const auto& cached : layouts) {
+            vkDestroyDescriptorSetLayout(device_, cached.layout.layout, nullptr);
+        }
+    }
+}
+
+Opt<DescriptorSetLayout> DescriptorAllocator::getLayout(
+      const std::vector<VkDescriptorSetLayoutBinding>& bindings
+    , const std::vector<VkDescriptorBindingFlagsEXT>&  binding_flags)
+{
+    std::lock_guard lock{ mutex_ };
+    auto& bucket = layouts_[hashLayout(bindings, binding_flags)];
+    const auto it = std::ranges::find_if(bucket, [&](const auto& cached) { return sameLayout(cached, bindings, binding_flags); });
+    if (it != bucket.end()) {
+        return it->layout;
+    }
+
+    DescriptorSetLayout layout{};
+    for (size_t i = 0; i != bindings.size(); ++i) {
+        const auto& dslb = bindings[i];
+        const auto flags = i < binding_flags.size() ? binding_flags[i] : 0;
+        if (flags & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT) {
+            layout.variable_count = dslb.descriptorCount;
+        }
+        layout.update_after_bind |= (flags & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT) != 0;
+
+        const auto size = std::ranges::find(layout.sizes, dslb.descriptorType, &VkDescriptorPoolSize::type);
+        if (size == layout.sizes.end()) {
+            layout.sizes.push_back({ dslb.descriptorType, dslb.descriptorCount });
+        }
+        else {
+            size->descriptorCount += dslb.descriptorCount;
+        }
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT dslbfci = initDescriptorSetLayoutBindingFlagsCreateInfo(binding_flags);
+    VkDescriptorSetLayoutCreateInfo dslci = initDescriptorSetLayoutCreateInfo(bindings, dslbfci, layout.update_after_bind);
+    VULKAN_IF_ERROR_RETURN(vkCreateDescriptorSetLayout(device_, &dslci, nullptr, &layout.layout));
+    bucket.emplace_back(bindings, binding_flags, layout);
+    return layout;
+}
+
+Opt<VkDescriptorSet> DescriptorAllocator::allocate(const DescriptorSetLayout& layout)
+{
+    std::lock_guard lock{ mutex_ };
+    return persistent_->allocate(layout);
+}
+
+Opt<VkDescriptorSet> DescriptorAllocator::allocateTransient(const DescriptorSetLayout& layout)
+{
+    std::lock_guard lock{ mutex_ };
+    return frames_[current_frame_]->allocate(layout);
+}
+
+bool DescriptorAllocator::beginFrame(uint32_t frame)
+{
+    std::lock_guard lock{ mutex_ };
+    current_frame_ = frame;
+    return frames_[current_frame_]->reset();
+}
+
+DescriptorAllocator::DescriptorAllocator(VkDevice device, uint32_t update_after_bind_limit) noexcept
+    : device_{ device }
+    , update_after_bind_budget_{ update_after_bind_limit }
+{}
+
+size_t DescriptorAllocator::hashLayout(
+      const std::vector<VkDescriptorSetLayoutBinding>& bindings
+    , const std::vector<VkDescriptorBindingFlagsEXT>&  binding_flags)
+{
+    size_t seed = 0;
+    for (const auto& dslb : bindings) {
+        util::hash_combine(seed, dslb.binding);
+        util::hash_combine(seed, dslb.descriptorType);
+        util::hash_combine(seed, dslb.descriptorCount);
+        util::hash_combine(seed, dslb.stageFlags);
+    }
+    for (const auto& flags : binding_flags) {
+        util::hash_combine(seed, flags);
+    }
+    return seed;
+}
+
+bool DescriptorAllocator::sameLayout(
+      const CachedLayout&                              cached
+    , const std::vector<VkDescriptorSetLayoutBinding>& bindings
+    , const std::vector<VkDescriptorBindingFlagsEXT>&  binding_flags)
+{
+    const auto same_binding = [](const auto& lhs, const auto& rhs) {
+        return lhs.binding == rhs.binding
+            && lhs.descriptorType == rhs.descriptorType
+            && lhs.descriptorCount == rhs.descriptorCount
+            && lhs.stageFlags == rhs.stageFlags
+            && lhs.pImmutableSamplers == rhs.pImmutableSamplers;
+    };
+    return std::ranges::equal(cached.bindings, bindings, same_binding)
+        && cached.binding_flags == binding_flags;
+}
+
+VkDescriptorSetLayoutBindingFlagsCreateInfoEXT DescriptorAllocator::initDescriptorSetLayoutBindingFlagsCreateInfo(const std::vector<VkDescriptorBindingFlagsEXT>& flags)
+{
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT dslbfci = {};
+    dslbfci.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    dslbfci.pNext         = nullptr;
+    dslbfci.bindingCount  = static_cast<uint32_t>(flags.size());
+    dslbfci.pBindingFlags = flags.data();
+    return dslbfci;
+}
+
+VkDescriptorSetLayoutCreateInfo DescriptorAllocator::initDescriptorSetLayoutCreateInfo(
+      const std::vector<VkDescriptorSetLayoutBinding>&      bindings
+    , const VkDescriptorSetLayoutBindingFlagsCreateInfoEXT& dslbfci
+    , bool                                                  update_after_bind)
+{
+    VkDescriptorSetLayoutCreateInfo dslci = {};
+    dslci.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    dslci.pNext        = dslbfci.bindingCount ? &dslbfci : nullptr;
+    dslci.flags        = update_after_bind ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT : 0;
+    dslci.bindingCount = static_cast<uint32_t>(bindings.size());
+    dslci.pBindings    = bindings.data();
+    return dslci;
+}
+
+} // namespace vulkan
@@ -0,0 +1,86 @@
+#include "model.hpp"
+
+#include "vulkan/geometry_pool.hpp"
+#include "vulkan/renderer.hpp"
+#include "vulkan/window.hpp"
+
+namespace vulkan {
+namespace details {
+
+Ptr<PoolBuffer> PoolBuffer::create(const Window& window, BufferUsage usage, MemoryStats::Category category, uint32_t capacity) noexcept
+{
+    const auto buf = initBuffer(window, static_cast<VkBufferUsageFlagBits>(usage), capacity);
+    if (!buf) {
+        return util::handle_error();
+    }
+
+    auto buffer = Ptr<PoolBuffer>{ new PoolBuffer{ window, *buf, capacity } };
+    if (!buffer->initBufferBase(category)) {
+        return util::handle_error();
+    }
+    return buffer;
+}
+
+PoolBuffer::PoolBuffer(const Window& window, VkBuffer buffer, uint32_t capacity) noexcept
+    : BufferHandle{ window, buffer, capacity, 0u }
+{}
+
+} // namespace details
+
+GeometryPoolHandle::GeometryPoolHandle(const Window& window) noexcept
+    : window_{ window }
+{}
+
+bool GeometryPoolHandle::write(Ptr<details::PoolBuffer>& buffer, BufferUsage usage, const void* data, size_t offset, size_t size)
+{
+    const auto required = offset + size;
+    if (!buffer || buffer->size_ < required) {
+        const auto capacity = grownCapacity(buffer ? buffer->size_ : 0u, required);
+        auto grown = details::PoolBuffer::create(window_, usage, MemoryStats::Category::Geometry, static_cast<uint32_t>(capacity));
+        if (!grown) {
+            return util::handle_error();
+        }
+        // frames are waited on in Window::swapFramebuffers, so the old buffer is not in use anymore
+        buffer = std::move(grown);
+        offset = 0;
+    }
+    std::memcpy(static_cast<char*>(buffer->mapped_) + offset, static_cast<const char*>(data) + offset, required - offset);
+    return true;
+}
+
+void GeometryPoolHandle::bind(VkCommandBuffer command_buffer) const
+{
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer_->buffer_, &offset);
+    vkCmdBindIndexBuffer(command_buffer, index_buffer_->buffer_, offset, VK_INDEX_TYPE_UINT32);
+}
+
+template<typename V>
+DLL_EXPORT Ptr<GeometryPool<V>> GeometryPool<V>::create() noexcept
+{
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    return Ptr<GeometryPool>{ new GeometryPool{ window } };
+}
+
+template<typename V>
+GeometryPool<V>::GeometryPool(const Window& window) noexcept
+    : GeometryPoolHandle{ window }
+{}
+
+template<typename V>
+bool GeometryPool<V>::upload(size_t first_vertex, size_t first_index)
+{
+    const auto& vertices = impl::GeometryPool<V>::vertices_;
+    const auto& indices = impl::GeometryPool<V>::indices_;
+    if (!write(vertex_buffer_, BufferUsage::Vertex, vertices.data(), first_vertex * sizeof(V), (vertices.size() - first_vertex) * sizeof(V))) {
+        return util::handle_error();
+    }
+    if (!write(index_buffer_, BufferUsage::Index, indices.data(), first_index * sizeof(uint32_t), (indices.size() - first_index) * sizeof(uint32_t))) {
+        return util::handle_error();
+    }
+    return true;
+}
+
+template class GeometryPool<Vertex>;
+
+} // namespace vulkan
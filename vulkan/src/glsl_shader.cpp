@@ -1,3 +1,6 @@
+#include "startup_profile.hpp"
+#include "trace.hpp"
+
 #include "vulkan/glsl_shader.hpp"
 #include "vulkan/renderer.hpp"
 #include "vulkan/window.hpp"
@@ -8,20 +11,38 @@ DLL_EXPORT Ptr<GlslShader> GlslShader::create(ShaderType type, std::string_view
 {
     const auto shader_code = util::read_file_contents(path);
     const auto shader_type = static_cast<VkShaderStageFlagBits>(type);
+    const auto shader_kind = getShadercShaderType(shader_type);
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
 
-    shaderc::Compiler compiler{};
-    const auto compilation = compiler.CompileGlslToSpv(shader_code, getShadercShaderType(shader_type), path.data());
-    if (const auto result = compilation.GetCompilationStatus();
-        shaderc_compilation_status_success != result) {
-        return util::handle_error() << compilation.GetErrorMessage();
+    const auto& cache = window.spirv_cache_;
+    const auto key = details::SpirvCache::makeKey(path, shader_code, shader_kind, OptimizationLevel);
+    auto spirv_shader_code = [&]() {
+        const auto stage = StartupProfile::instance().stage("spirv cache lookup");
+        return cache ? cache->load(key, path) : std::nullopt;
+    }();
+    if (!spirv_shader_code) {
+        const auto stage = StartupProfile::instance().stage("compile");
+        spirv_shader_code = compile(shader_code, shader_kind, path);
+        if (!spirv_shader_code) {
+            return util::handle_error();
+        }
+        if (cache && !cache->store(key, *spirv_shader_code)) {
+            IGNORE(util::handle_error() << "Failed to cache " << path);
+        }
     }
+    return create(type, *spirv_shader_code);
+}
 
-    const std::vector<uint32_t> spirv_shader_code(compilation.cbegin(), compilation.cend());
-    VkShaderModuleCreateInfo fsmci = initShaderModuleCreateInfo(spirv_shader_code);
+DLL_EXPORT Ptr<GlslShader> GlslShader::create(ShaderType type, std::span<const uint32_t> spirv) noexcept
+{
+    VkShaderModuleCreateInfo smci = initShaderModuleCreateInfo(spirv);
 
     const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
-    auto shader = Ptr<GlslShader>{ new GlslShader{ window.device_, shader_type} };
-    VULKAN_IF_ERROR_RETURN(vkCreateShaderModule(shader->device_, &fsmci, nullptr, &shader->shader_));
+    auto shader = Ptr<GlslShader>{ new GlslShader{ window.device_, static_cast<VkShaderStageFlagBits>(type) } };
+    shader->code_hash_ = util::fnv1a({ reinterpret_cast<const char*>(spirv.data()), spirv.size_bytes() });
+    VULKAN_IF_ERROR_RETURN(vkCreateShaderModule(shader->device_, &smci, nullptr, &shader->shader_));
+    // the driver keeps its own copy of the code for as long as the module lives
+    shader->code_memory_ = { MemoryStats::Heap::Host, MemoryStats::Category::ShaderCode, spirv.size_bytes() };
     return shader;
 }
 
@@ -35,13 +56,29 @@ GlslShader::GlslShader(VkDevice device, VkShaderStageFlagBits type) noexcept
     , type_{type}
 {}
 
-VkShaderModuleCreateInfo GlslShader::initShaderModuleCreateInfo(const std::vector<uint32_t>& shader_code)
+Opt<std::vector<uint32_t>> GlslShader::compile(const std::string& shader_code, shaderc_shader_kind kind, std::string_view path)
+{
+    TRACE_ZONE("GlslShader::compile");
+    shaderc::CompileOptions options{};
+    options.SetOptimizationLevel(OptimizationLevel);
+
+    // shaderc::Compiler must not be shared between threads, each one compiling shaders keeps its own
+    thread_local shaderc::Compiler compiler{};
+    const auto compilation = compiler.CompileGlslToSpv(shader_code, kind, path.data(), options);
+    if (const auto result = compilation.GetCompilationStatus();
+        shaderc_compilation_status_success != result) {
+        return util::handle_error() << compilation.GetErrorMessage();
+    }
+    return std::vector<uint32_t>(compilation.cbegin(), compilation.cend());
+}
+
+VkShaderModuleCreateInfo GlslShader::initShaderModuleCreateInfo(std::span<const uint32_t> shader_code)
 {
     VkShaderModuleCreateInfo smci = {};
     smci.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     smci.pNext    = nullptr;
     smci.flags    = 0;
-    smci.codeSize = (sizeof(uint32_t) / sizeof(char)) * shader_code.size();
+    smci.codeSize = shader_code.size_bytes();
     smci.pCode    = shader_code.data();
     return smci;
 }
@@ -54,13 +91,15 @@ shaderc_shader_kind GlslShader::getShadercShaderType(VkShaderStageFlagBits type)
     if (type & VK_SHADER_STAGE_FRAGMENT_BIT) {
         return shaderc_glsl_fragment_shader;
     }
+    if (type & VK_SHADER_STAGE_COMPUTE_BIT) {
+        return shaderc_glsl_compute_shader;
+    }
     std::unreachable();
 }
 
-void GlslShader::attachUniformBlock(VkDescriptorSetLayout layout, VkBuffer buffer, uint32_t buffer_size)
+void GlslShader::attachUniformBlock(VkBuffer buffer, uint32_t buffer_size, uint32_t binding)
 {
-    descriptor_set_layouts_.push_back(layout);
-    uniform_buffers_.emplace_back(buffer, buffer_size);
+    uniform_buffers_.emplace_back(buffer, buffer_size, binding, type_);
 }
 
 } // namespace vulkan
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <array>
+
+#include "vulkan/gpu_profiler.hpp"
+#include "vulkan/renderer.hpp"
+
+namespace vulkan {
+namespace details {
+
+Ptr<GpuProfiler> GpuProfiler::create(VkPhysicalDevice physical_device, VkDevice device, uint32_t queue_family_index, uint32_t frame_count) noexcept
+{
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+    VkPhysicalDeviceFeatures features = {};
+    vkGetPhysicalDeviceFeatures(physical_device, &features);
+    uint32_t family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families.data());
+
+    const auto timestamp_bits = families.at(queue_family_index).timestampValidBits;
+    if (timestamp_bits == 0 && !features.pipelineStatisticsQuery) {
+        return util::handle_error() << "neither timestamps nor pipeline statistics are supported";
+    }
+
+    Ptr<GpuProfiler> profiler{ new GpuProfiler{ device, frame_count } };
+    if (timestamp_bits != 0) {
+        VkQueryPoolCreateInfo qpci = initQueryPoolCreateInfo(VK_QUERY_TYPE_TIMESTAMP, TimestampCount * frame_count, 0);
+        VULKAN_IF_ERROR_RETURN(vkCreateQueryPool(device, &qpci, nullptr, &profiler->timestamps_));
+        profiler->timestamp_period_ = properties.limits.timestampPeriod;
+        profiler->timestamp_mask_ = timestamp_bits == 64 ? ~0ull : (1ull << timestamp_bits) - 1;
+    }
+    // enabled with every other supported feature when the device was created
+    if (features.pipelineStatisticsQuery) {
+        VkQueryPoolCreateInfo qpci = initQueryPoolCreateInfo(VK_QUERY_TYPE_PIPELINE_STATISTICS, frame_count, Statistics);
+        VULKAN_IF_ERROR_RETURN(vkCreateQueryPool(device, &qpci, nullptr, &profiler->statistics_));
+    }
+    return profiler;
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    if (timestamps_) {
+        vkDestroyQueryPool(device_, timestamps_, nullptr);
+    }
+    if (statistics_) {
+        vkDestroyQueryPool(device_, statistics_, nullptr);
+    }
+}
+
+void GpuProfiler::begin(VkCommandBuffer command_buffer, uint32_t frame)
+{
+    if (recorded_[frame]) {
+        collect(frame);
+    }
+    if (timestamps_) {
+        vkCmdResetQueryPool(command_buffer, timestamps_, frame * TimestampCount, TimestampCount);
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestamps_, frame * TimestampCount + FrameBegin);
+    }
+    if (statistics_) {
+        vkCmdResetQueryPool(command_buffer, statistics_, frame, 1);
+        vkCmdBeginQuery(command_buffer, statistics_, frame, 0);
+    }
+    recorded_[frame] = true;
+}
+
+void GpuProfiler::beginRenderPass(VkCommandBuffer command_buffer, uint32_t frame)
+{
+    if (timestamps_) {
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamps_, frame * TimestampCount + RenderPassBegin);
+    }
+}
+
+void GpuProfiler::end(VkCommandBuffer command_buffer, uint32_t frame)
+{
+    if (statistics_) {
+        vkCmdEndQuery(command_buffer, statistics_, frame);
+    }
+    if (timestamps_) {
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamps_, frame * TimestampCount + FrameEnd);
+    }
+}
+
+void GpuProfiler::collect(uint32_t frame)
+{
+    constexpr VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+    impl::GpuFrameStats stats{};
+
+    if (timestamps_) {
+        // value and availability of every query, without VK_QUERY_RESULT_WAIT_BIT this does not block
+        std::array<uint64_t, TimestampCount * 2> results{};
+        const auto result = vkGetQueryPoolResults(
+              device_, timestamps_, frame * TimestampCount, TimestampCount
+            , sizeof(results), results.data(), 2 * sizeof(uint64_t), flags);
+        if (result != VK_SUCCESS || !results[FrameBegin * 2 + 1] || !results[RenderPassBegin * 2 + 1] || !results[FrameEnd * 2 + 1]) {
+            return;
+        }
+        const auto elapsed_us = [&](Timestamp from, Timestamp to) {
+            const auto ticks = (results[to * 2] - results[from * 2]) & timestamp_mask_;
+            return ticks * timestamp_period_ / 1000.0;
+        };
+        // everything recorded before the clear command begins the render pass, the dispatches
+        stats.passes.push_back({ "compute", elapsed_us(FrameBegin, RenderPassBegin) });
+        stats.passes.push_back({ "render_pass", elapsed_us(RenderPassBegin, FrameEnd) });
+    }
+
+    if (statistics_) {
+        std::array<uint64_t, StatisticCount + 1> results{};
+        const auto result = vkGetQueryPoolResults(device_, statistics_, frame, 1, sizeof(results), results.data(), sizeof(results), flags);
+        if (result != VK_SUCCESS || !results[StatisticCount]) {
+            return;
+        }
+        stats.input_primitives           = results[0];
+        stats.vertex_invocations         = results[1];
+        stats.clipping_input_primitives  = results[2];
+        stats.clipping_output_primitives = results[3];
+        stats.fragment_invocations       = results[4];
+    }
+
+    latest_ = std::move(stats);
+    ++completed_frames_;
+}
+
+GpuProfiler::GpuProfiler(VkDevice device, uint32_t frame_count) noexcept
+    : device_{ device }
+    , recorded_(frame_count, false)
+{}
+
+VkQueryPoolCreateInfo GpuProfiler::initQueryPoolCreateInfo(VkQueryType type, uint32_t count, VkQueryPipelineStatisticFlags statistics)
+{
+    VkQueryPoolCreateInfo qpci = {};
+    qpci.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    qpci.pNext              = nullptr;
+    qpci.flags              = 0;
+    qpci.queryType          = type;
+    qpci.queryCount         = count;
+    qpci.pipelineStatistics = statistics;
+    return qpci;
+}
+
+} // namespace details
+} // namespace vulkan
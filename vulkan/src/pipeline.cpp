@@ -1,3 +1,8 @@
+#include <chrono>
+#include <future>
+
+#include "constants.h"
+
 #include "vulkan/pipeline.hpp"
 #include "vulkan/renderer.hpp"
 #include "vulkan/vertex_description.hpp"
@@ -6,9 +11,9 @@
 namespace vulkan {
 namespace details {
 
-Ptr<RenderPass> RenderPass::create(VkDevice device, VkFormat surface_format) noexcept
+Ptr<RenderPass> RenderPass::create(VkDevice device, VkFormat surface_format, VkImageLayout final_layout) noexcept
 {
-    const auto color_attachment = initColorAttachmentDescription(surface_format);
+    const auto color_attachment = initColorAttachmentDescription(surface_format, final_layout);
     const auto depth_attachment = initDepthAttachmentDescription();
 
     auto render_pass = Ptr<RenderPass>{ new RenderPass{device} };
@@ -35,7 +40,7 @@ RenderPass::RenderPass(VkDevice device) noexcept
     : device_{ device }
 {}
 
-VkAttachmentDescription RenderPass::initColorAttachmentDescription(VkFormat surface_format)
+VkAttachmentDescription RenderPass::initColorAttachmentDescription(VkFormat surface_format, VkImageLayout final_layout)
 {
     VkAttachmentDescription ad = {};
     ad.flags          = 0;
@@ -46,7 +51,7 @@ VkAttachmentDescription RenderPass::initColorAttachmentDescription(VkFormat surf
     ad.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     ad.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     ad.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-    ad.finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    ad.finalLayout    = final_layout;
     return ad;
 }
 
@@ -111,12 +116,37 @@ VkRenderPassCreateInfo RenderPass::initRenderPassCreateInfo(
     return rpci;
 }
 
+Ptr<Specialization> Specialization::create(const impl::SpecializationConstants& constants)
+{
+    if (constants.values().empty()) {
+        return nullptr;
+    }
+    auto specialization = std::make_unique<Specialization>();
+    for (const auto& [id, bits] : constants.values()) {
+        const auto offset = static_cast<uint32_t>(specialization->data.size() * sizeof(uint32_t));
+        specialization->map_entries.push_back(VkSpecializationMapEntry{ id, offset, sizeof(uint32_t) });
+        specialization->data.push_back(bits);
+    }
+    specialization->info = initSpecializationInfo(specialization->map_entries, specialization->data);
+    return specialization;
+}
+
+VkSpecializationInfo Specialization::initSpecializationInfo(const std::vector<VkSpecializationMapEntry>& map_entries, const std::vector<uint32_t>& data)
+{
+    VkSpecializationInfo si = {};
+    si.mapEntryCount = static_cast<uint32_t>(map_entries.size());
+    si.pMapEntries   = map_entries.data();
+    si.dataSize      = data.size() * sizeof(uint32_t);
+    si.pData         = data.data();
+    return si;
+}
+
 } // namespace details
 
 DLL_EXPORT Ptr<Pipeline> Pipeline::create() noexcept
 {
     const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
-    return Ptr<Pipeline>{ new Pipeline{ window.device_ } };
+    return Ptr<Pipeline>{ new Pipeline{ window.device_, window.pipeline_cache_ } };
 }
 
 DLL_EXPORT Pipeline::~Pipeline() noexcept
@@ -124,21 +154,35 @@ DLL_EXPORT Pipeline::~Pipeline() noexcept
     if (!device_) {
         return;
     }
+    if (optimized_.valid()) {
+        if (const auto optimized = optimized_.get()) {
+            vkDestroyPipeline(device_, optimized, nullptr);
+        }
+    }
+    if (retired_) {
+        vkDestroyPipeline(device_, retired_, nullptr);
+    }
     if (pipeline_) {
         vkDestroyPipeline(device_, pipeline_, nullptr);
     }
     if (pipeline_layout_) {
         vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
     }
-    if (pipeline_cache_) {
-        vkDestroyPipelineCache(device_, pipeline_cache_, nullptr);
-    }
 }
-DLL_EXPORT void Pipeline::addShader(const impl::GlslShader& shader)
+
+DLL_EXPORT void Pipeline::addShader(const impl::GlslShader& shader, const impl::SpecializationConstants& constants)
 {
     const auto& shad = dynamic_cast<const GlslShader&>(shader);
-    pipeline_shader_stage_create_infos_.push_back(initPipelineShaderStageCreateInfo(shad.shader_, shad.type_));
-    std::ranges::for_each(shad.descriptor_set_layouts_, [this](const auto& layout) { descriptor_set_layouts_.push_back(layout); });
+    uint64_t code_hash = shad.code_hash_;
+    for (const auto& [id, bits] : constants.values()) {
+        code_hash = util::fnv1a(util::as_bytes(id), util::fnv1a(util::as_bytes(bits), code_hash));
+    }
+    const VkSpecializationInfo* specialization_info = nullptr;
+    if (auto specialization = details::Specialization::create(constants)) {
+        specialization_info = &specializations_.emplace_back(std::move(specialization))->info;
+    }
+    pipeline_shader_stage_create_infos_.push_back(initPipelineShaderStageCreateInfo(shad.shader_, shad.type_, specialization_info));
+    shader_code_hashes_.push_back(code_hash);
     std::ranges::for_each(shad.uniform_buffers_, [this](const auto& buffer_info) { uniform_buffers_.push_back(buffer_info); });
 }
 
@@ -146,9 +190,6 @@ DLL_EXPORT bool Pipeline::use(const impl::VertexDescription& description)
 {
     const auto& descr = dynamic_cast<const VertexDescription&>(description);
 
-    VkPipelineCacheCreateInfo pcci = initPipelineCacheCreateInfo();
-    VULKAN_IF_ERROR_RETURN(vkCreatePipelineCache(device_, &pcci, nullptr, &pipeline_cache_));
-
     if (!descr.vertex_input_binding_description_) {
         return util::handle_error();
     }
@@ -176,6 +217,34 @@ DLL_EXPORT bool Pipeline::use(const impl::VertexDescription& description)
     const std::vector<VkPipelineColorBlendAttachmentState> attachments{ initPipelineColorBlendAttachmentState() };
     VkPipelineColorBlendStateCreateInfo pcbsci = initPipelineColorBlendStateCreateInfo(attachments);
 
+    // one set per frame: uniform blocks (the same binding once per frame) and the bindless objects[] array
+    // of per-object buffers, the per-draw MVP and the draw's index into objects[] are push constants
+    std::vector<VkDescriptorSetLayoutBinding> bindings{};
+    for (const auto& ub : uniform_buffers_) {
+        if (ub.binding >= DRAW_DATA_BINDING) {
+            return util::handle_error() << "Variable sized binding " << DRAW_DATA_BINDING << " has to be the last one";
+        }
+        if (std::ranges::none_of(bindings, [&ub](const auto& dslb) { return dslb.binding == ub.binding; })) {
+            bindings.push_back(initDescriptorSetLayoutBinding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, ub.binding, ub.stage, 1));
+        }
+    }
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    bindings.push_back(initDescriptorSetLayoutBinding(
+          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+        , DRAW_DATA_BINDING
+        , VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT
+        , window.bindless_descriptor_count_
+    ));
+    std::vector<VkDescriptorBindingFlagsEXT> binding_flags(bindings.size(), 0);
+    binding_flags.back() = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT
+                         | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT
+                         | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;
+    auto descriptor_set_layout = window.descriptor_allocator_->getLayout(bindings, binding_flags);
+    if (!descriptor_set_layout) {
+        return util::handle_error();
+    }
+    descriptor_set_layout_ = std::move(*descriptor_set_layout);
+
     VkPipelineLayoutCreateInfo plci = initPipelineLayoutCreateInfo();
     VULKAN_IF_ERROR_RETURN(vkCreatePipelineLayout(device_, &plci, nullptr, &pipeline_layout_));
 
@@ -187,18 +256,115 @@ DLL_EXPORT bool Pipeline::use(const impl::VertexDescription& description)
         }
         format = static_cast<VkFormat>(*surface_format);
     }
-    render_pass_ = details::RenderPass::create(device_, format);
+    // offscreen images are never presented, they stay ready to be copied from
+    const auto final_layout = window.headless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    render_pass_ = details::RenderPass::create(device_, format, final_layout);
 
     VkGraphicsPipelineCreateInfo gpci = initGraphicsPipelineCreateInfo(pvisci, piasci, pvsci, prsci, pmsci, pdssci, pcbsci);
-    VULKAN_IF_ERROR_RETURN(vkCreateGraphicsPipelines(device_, pipeline_cache_, 1, &gpci, nullptr, &pipeline_));
+    const auto start = std::chrono::high_resolution_clock::now();
+    if (window.pipeline_libraries_) {
+        uint64_t vertex_input_key = util::fnv1a(util::as_bytes(*descr.vertex_input_binding_description_));
+        for (const auto& attribute : descr.vertex_input_attribute_descriptions_) {
+            vertex_input_key = util::fnv1a(util::as_bytes(attribute), vertex_input_key);
+        }
+        vertex_input_key = util::fnv1a(util::as_bytes(piasci.topology), vertex_input_key);
+        const uint64_t pre_rasterization_key = util::fnv1a(util::as_bytes(extent), getLayoutKey(VK_SHADER_STAGE_VERTEX_BIT));
+        const uint64_t fragment_shader_key = getLayoutKey(VK_SHADER_STAGE_FRAGMENT_BIT);
+        const uint64_t fragment_output_key = util::fnv1a(util::as_bytes(format));
+        if (!linkLibraries(*window.pipeline_libraries_, gpci, { vertex_input_key, pre_rasterization_key, fragment_shader_key, fragment_output_key })) {
+            return util::handle_error();
+        }
+    }
+    else {
+        VULKAN_IF_ERROR_RETURN(vkCreateGraphicsPipelines(device_, pipeline_cache_, 1, &gpci, nullptr, &pipeline_));
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Pipeline creation time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+              << (window.pipeline_cache_warm_ ? " (warm pipeline cache" : " (cold pipeline cache")
+              << (window.pipeline_libraries_ ? ", linked from libraries)" : ")") << "\n";
     return true;
 }
 
-Pipeline::Pipeline(VkDevice device) noexcept
+VkPipeline Pipeline::current() const
+{
+    // the fast-linked pipeline may still be in flight, so it is kept until destruction
+    using namespace std::chrono_literals;
+    if (optimized_.valid() && optimized_.wait_for(0s) == std::future_status::ready) {
+        if (const auto optimized = optimized_.get()) {
+            retired_ = std::exchange(pipeline_, optimized);
+        }
+    }
+    return pipeline_;
+}
+
+uint64_t Pipeline::getLayoutKey(VkShaderStageFlagBits stage) const
+{
+    // layouts are cached by the descriptor allocator, so equal handles mean equal layouts
+    uint64_t key = util::fnv1a(util::as_bytes(descriptor_set_layout_.layout));
+    for (size_t i = 0; i != pipeline_shader_stage_create_infos_.size(); ++i) {
+        if (pipeline_shader_stage_create_infos_[i].stage == stage) {
+            key = util::fnv1a(util::as_bytes(shader_code_hashes_[i]), key);
+        }
+    }
+    return key;
+}
+
+bool Pipeline::linkLibraries(details::PipelineLibraryCache& libraries, const VkGraphicsPipelineCreateInfo& gpci, const std::array<uint64_t, 4>& keys)
+{
+    constexpr std::array<VkGraphicsPipelineLibraryFlagBitsEXT, 4> parts{
+          VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT
+        , VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT
+        , VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT
+        , VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+    };
+    std::array<VkPipeline, 4> parts_libraries{};
+    for (size_t i = 0; i != parts.size(); ++i) {
+        const VkShaderStageFlags stage = parts[i] == VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT ? VK_SHADER_STAGE_VERTEX_BIT
+                                       : parts[i] == VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT       ? VK_SHADER_STAGE_FRAGMENT_BIT
+                                       : 0;
+        std::vector<VkPipelineShaderStageCreateInfo> stages{};
+        std::ranges::copy_if(pipeline_shader_stage_create_infos_, std::back_inserter(stages), [stage](const auto& pssci) { return (pssci.stage & stage) != 0; });
+
+        // state in gpci that belongs to the other parts is ignored
+        VkGraphicsPipelineLibraryCreateInfoEXT gplci = initGraphicsPipelineLibraryCreateInfo(parts[i]);
+        VkGraphicsPipelineCreateInfo library_gpci = gpci;
+        library_gpci.pNext      = &gplci;
+        library_gpci.flags      = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+        library_gpci.stageCount = static_cast<uint32_t>(stages.size());
+        library_gpci.pStages    = stages.data();
+        const auto library = libraries.get(util::fnv1a(util::as_bytes(parts[i]), keys[i]), library_gpci);
+        if (!library) {
+            return util::handle_error();
+        }
+        parts_libraries[i] = *library;
+    }
+
+    // linking without optimization is what makes a new combination cheap, the optimized one replaces it when ready
+    VkPipelineLibraryCreateInfoKHR plci = initPipelineLibraryCreateInfo(parts_libraries);
+    VkGraphicsPipelineCreateInfo linked_gpci = initLinkedGraphicsPipelineCreateInfo(plci, 0);
+    VULKAN_IF_ERROR_RETURN(vkCreateGraphicsPipelines(device_, pipeline_cache_, 1, &linked_gpci, nullptr, &pipeline_));
+
+    if (Config::instance().get<uint32_t>("vk_background_pipeline_optimization").value_or(0)) {
+        optimized_ = std::async(std::launch::async, [this, parts_libraries]() {
+            VkPipelineLibraryCreateInfoKHR plci = initPipelineLibraryCreateInfo(parts_libraries);
+            VkGraphicsPipelineCreateInfo optimized_gpci = initLinkedGraphicsPipelineCreateInfo(plci, VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT);
+            VkPipeline optimized = VK_NULL_HANDLE;
+            if (const auto result = vkCreateGraphicsPipelines(device_, pipeline_cache_, 1, &optimized_gpci, nullptr, &optimized); result != VK_SUCCESS) {
+                IGNORE(util::handle_error() << "VkResult = " << result);
+                return VkPipeline{ VK_NULL_HANDLE };
+            }
+            return optimized;
+        });
+    }
+    return true;
+}
+
+Pipeline::Pipeline(VkDevice device, VkPipelineCache pipeline_cache) noexcept
     : device_{ device }
+    , pipeline_cache_{ pipeline_cache }
 {}
 
-VkPipelineShaderStageCreateInfo Pipeline::initPipelineShaderStageCreateInfo(VkShaderModule shader_module, VkShaderStageFlagBits shader_type)
+VkPipelineShaderStageCreateInfo Pipeline::initPipelineShaderStageCreateInfo(VkShaderModule shader_module, VkShaderStageFlagBits shader_type, const VkSpecializationInfo* specialization_info)
 {
     VkPipelineShaderStageCreateInfo vpssci = {};
     vpssci.sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -207,19 +373,19 @@ VkPipelineShaderStageCreateInfo Pipeline::initPipelineShaderStageCreateInfo(VkSh
     vpssci.stage               = shader_type;
     vpssci.module              = shader_module;
     vpssci.pName               = "main";
-    vpssci.pSpecializationInfo = nullptr;
+    vpssci.pSpecializationInfo = specialization_info;
     return vpssci;
 }
 
-VkPipelineCacheCreateInfo Pipeline::initPipelineCacheCreateInfo()
+VkDescriptorSetLayoutBinding Pipeline::initDescriptorSetLayoutBinding(VkDescriptorType type, uint32_t binding, VkShaderStageFlags stages, uint32_t count)
 {
-    VkPipelineCacheCreateInfo pcci = {};
-    pcci.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-    pcci.pNext           = nullptr;
-    pcci.flags           = 0;
-    pcci.initialDataSize = 0;
-    pcci.pInitialData    = nullptr;
-    return pcci;
+    VkDescriptorSetLayoutBinding dslb = {};
+    dslb.binding            = binding;
+    dslb.descriptorType     = type;
+    dslb.descriptorCount    = count;
+    dslb.stageFlags         = stages;
+    dslb.pImmutableSamplers = nullptr;
+    return dslb;
 }
 
 VkPipelineVertexInputStateCreateInfo Pipeline::initPipelineVertexInputStateCreateInfo(
@@ -356,10 +522,10 @@ VkPipelineLayoutCreateInfo Pipeline::initPipelineLayoutCreateInfo()
     plci.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     plci.pNext                  = nullptr;
     plci.flags                  = 0;
-    plci.setLayoutCount         = static_cast<uint32_t>(descriptor_set_layouts_.size());
-    plci.pSetLayouts            = descriptor_set_layouts_.data();
-    plci.pushConstantRangeCount = 0;
-    plci.pPushConstantRanges    = nullptr;
+    plci.setLayoutCount         = 1;
+    plci.pSetLayouts            = &descriptor_set_layout_.layout;
+    plci.pushConstantRangeCount = 1;
+    plci.pPushConstantRanges    = &DrawConstantsRange;
     return plci;
 }
 
@@ -395,4 +561,33 @@ VkGraphicsPipelineCreateInfo Pipeline::initGraphicsPipelineCreateInfo(
     return gpci;
 }
 
+VkGraphicsPipelineLibraryCreateInfoEXT Pipeline::initGraphicsPipelineLibraryCreateInfo(VkGraphicsPipelineLibraryFlagsEXT flags)
+{
+    VkGraphicsPipelineLibraryCreateInfoEXT gplci = {};
+    gplci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+    gplci.pNext = nullptr;
+    gplci.flags = flags;
+    return gplci;
+}
+
+VkPipelineLibraryCreateInfoKHR Pipeline::initPipelineLibraryCreateInfo(const std::array<VkPipeline, 4>& libraries)
+{
+    VkPipelineLibraryCreateInfoKHR plci = {};
+    plci.sType        = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+    plci.pNext        = nullptr;
+    plci.libraryCount = static_cast<uint32_t>(libraries.size());
+    plci.pLibraries   = libraries.data();
+    return plci;
+}
+
+VkGraphicsPipelineCreateInfo Pipeline::initLinkedGraphicsPipelineCreateInfo(const VkPipelineLibraryCreateInfoKHR& plci, VkPipelineCreateFlags flags)
+{
+    VkGraphicsPipelineCreateInfo gpci = {};
+    gpci.sType  = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    gpci.pNext  = &plci;
+    gpci.flags  = flags;
+    gpci.layout = pipeline_layout_;
+    return gpci;
+}
+
 } // namespace opengl
\ No newline at end of file
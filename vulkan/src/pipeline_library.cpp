@@ -0,0 +1,47 @@
+#include "vulkan/pipeline_library.hpp"
+#include "vulkan/renderer.hpp"
+
+namespace vulkan {
+namespace details {
+
+Ptr<PipelineLibraryCache> PipelineLibraryCache::create(VkDevice device, VkPipelineCache pipeline_cache) noexcept
+{
+    return Ptr<PipelineLibraryCache>{ new PipelineLibraryCache{ device, pipeline_cache } };
+}
+
+PipelineLibraryCache::~PipelineLibraryCache()
+{
+    for (const auto& [key, library] : libraries_) {
+        vkDestroyPipeline(device_, library, nullptr);
+    }
+}
+
+Opt<VkPipeline> PipelineLibraryCache::get(uint64_t key, const VkGraphicsPipelineCreateInfo& gpci)
+{
+    {
+        std::lock_guard lock{ mutex_ };
+        if (const auto it = libraries_.find(key); it != libraries_.end()) {
+            return it->second;
+        }
+    }
+
+    // created unlocked so pipelines being set up on other threads are not held up,
+    // when two threads race for the same part the loser's copy is thrown away
+    VkPipeline library = VK_NULL_HANDLE;
+    VULKAN_IF_ERROR_RETURN(vkCreateGraphicsPipelines(device_, pipeline_cache_, 1, &gpci, nullptr, &library));
+
+    std::lock_guard lock{ mutex_ };
+    const auto [it, inserted] = libraries_.emplace(key, library);
+    if (!inserted) {
+        vkDestroyPipeline(device_, library, nullptr);
+    }
+    return it->second;
+}
+
+PipelineLibraryCache::PipelineLibraryCache(VkDevice device, VkPipelineCache pipeline_cache) noexcept
+    : device_{ device }
+    , pipeline_cache_{ pipeline_cache }
+{}
+
+} // namespace details
+} // namespace vulkan
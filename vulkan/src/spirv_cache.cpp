@@ -0,0 +1,110 @@
+#include <iomanip>
+
+#include "constants.h"
+
+#include "vulkan/spirv_cache.hpp"
+
+namespace vulkan {
+namespace details {
+
+Ptr<SpirvCache> SpirvCache::create(std::string_view directory) noexcept
+{
+    std::error_code ec{};
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        return util::handle_error() << directory << ": " << ec.message();
+    }
+    return Ptr<SpirvCache>{ new SpirvCache{ directory } };
+}
+
+uint64_t SpirvCache::makeKey(std::string_view path, std::string_view source, shaderc_shader_kind kind, shaderc_optimization_level optimization)
+{
+    uint64_t hash = util::fnv1a(source);
+
+    // shaders are normally preprocessed at build time, includes left in the source still have to invalidate the entry
+    std::vector<std::filesystem::path> visited{};
+    hashIncludes(hash, path, source, visited);
+
+    // the same names are seen by the application, a shader compiled against other values must not be picked up
+    constexpr std::string_view defines[] = {
+          STR(UNIFORM_BUFFER_OBJECT)
+        , STR(VERTEX_POSITION_LOCATION)
+        , STR(VERTEX_COLOR_LOCATION)
+        , STR(UNIFORM_BLOCK_BINDING)
+        , STR(DRAW_DATA_BLOCK)
+        , STR(DRAW_DATA_BINDING)
+        , STR(DRAW_CONSTANTS_BLOCK)
+        , STR(DISTANCE_SHADING_CONSTANT_ID)
+        , STR(DISTANCE_SCALE_CONSTANT_ID)
+    };
+    for (const auto& define : defines) {
+        hash = util::fnv1a(define, hash);
+    }
+
+    unsigned int spv_version = 0, spv_revision = 0;
+    shaderc_get_spv_version(&spv_version, &spv_revision);
+    for (const auto value : { static_cast<uint32_t>(kind), static_cast<uint32_t>(optimization), spv_version, spv_revision }) {
+        hash = util::fnv1a({ reinterpret_cast<const char*>(&value), sizeof(value) }, hash);
+    }
+    return hash;
+}
+
+Opt<std::vector<uint32_t>> SpirvCache::load(uint64_t key, std::string_view path)
+{
+    auto spirv = util::read_binary_file<uint32_t>(getFilePath(key));
+    if (spirv && (spirv->empty() || spirv->front() != 0x07230203)) { // SPIR-V magic number
+        spirv.reset();
+    }
+
+    std::lock_guard lock{ mutex_ };
+    ++(spirv ? stats_.hits : stats_.misses);
+    std::cout << "SPIR-V cache " << (spirv ? "hit" : "miss") << ": " << path
+              << " (hits: " << stats_.hits << ", misses: " << stats_.misses << ")\n";
+    return spirv;
+}
+
+bool SpirvCache::store(uint64_t key, const std::vector<uint32_t>& spirv)
+{
+    const auto file_path = getFilePath(key);
+    if (!util::write_binary_file(file_path, spirv.data(), util::contained_data_size(spirv))) {
+        return util::handle_error() << file_path;
+    }
+    return true;
+}
+
+SpirvCache::SpirvCache(std::filesystem::path directory) noexcept
+    : directory_{ std::move(directory) }
+{}
+
+void SpirvCache::hashIncludes(uint64_t& hash, const std::filesystem::path& path, std::string_view source, std::vector<std::filesystem::path>& visited)
+{
+    constexpr std::string_view directive = "#include";
+    for (size_t pos = source.find(directive); pos != std::string_view::npos; pos = source.find(directive, pos + 1)) {
+        const auto first = source.find_first_of("\"<", pos + directive.size());
+        const auto last = first == std::string_view::npos ? first : source.find_first_of("\">", first + 1);
+        if (last == std::string_view::npos) {
+            break;
+        }
+        const auto include = path.parent_path() / source.substr(first + 1, last - first - 1);
+        if (std::ranges::find(visited, include) != visited.end()) {
+            continue;
+        }
+        visited.push_back(include);
+
+        // a missing include fails the compilation anyway, its name still goes into the key
+        const auto contents = util::read_file_contents(include.string().c_str());
+        hash = util::fnv1a(include.generic_string(), hash);
+        hash = util::fnv1a(contents, hash);
+        hashIncludes(hash, include, contents, visited);
+    }
+}
+
+std::filesystem::path SpirvCache::getFilePath(uint64_t key) const
+{
+    std::stringstream name{};
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".spv";
+    return directory_ / name.str();
+}
+
+} // namespace details
+} // namespace vulkan
@@ -1,5 +1,6 @@
 #include "constants.h"
 #include "model.hpp"
+#include "trace.hpp"
 
 #include "vulkan/glsl_shader.hpp"
 #include "vulkan/renderer.hpp"
@@ -20,36 +21,26 @@ Ptr<SingleUniformBlock<UBO>> SingleUniformBlock<UBO>::create(impl::GlslShader& s
     }
 
     auto ub = Ptr<details::SingleUniformBlock<UBO>>{ new details::SingleUniformBlock<UBO>{window, *buffer} };
-    if (!ub->BufferHandle::initBufferBase()) {
+    if (!ub->BufferHandle::initBufferBase(MemoryStats::Category::Uniforms)) {
         return util::handle_error();
     }
 
-    VkDescriptorSetLayoutBinding dslb = initDescriptorSetLayoutBinding(ub->getShaderStage(sh), binding);
-    VkDescriptorSetLayoutCreateInfo dslci = initDescriptorSetLayoutCreateInfo(dslb);
-    VULKAN_IF_ERROR_RETURN(vkCreateDescriptorSetLayout(ub->BufferHandle::device_, &dslci, nullptr, &ub->descriptor_set_layout_));
-
-    ub->attachUniformBlock(sh, ub->descriptor_set_layout_, ub->BufferHandle::buffer_, BufferSize);
+    ub->attachUniformBlock(sh, ub->BufferHandle::buffer_, BufferSize, binding);
     return ub;
 }
 
 template<typename UBO>
-SingleUniformBlock<UBO>::~SingleUniformBlock()
+size_t SingleUniformBlock<UBO>::upload(const UBO& ubo)
 {
-    if (BufferHandle::device_ && descriptor_set_layout_) {
-        vkDestroyDescriptorSetLayout(BufferHandle::device_, descriptor_set_layout_, nullptr);
+    if (!initialized_) {
+        std::memcpy(BufferHandle::mapped_, &ubo, BufferSize);
+        uploaded_ = ubo;
+        initialized_ = true;
+        return BufferSize;
     }
-}
-
-template<typename UBO>
-void SingleUniformBlock<UBO>::update()
-{
-    std::memcpy(BufferHandle::mapped_, &ubo_, BufferSize);
-}
-
-template<typename UBO>
-UBO& SingleUniformBlock<UBO>::get()
-{
-    return ubo_;
+    return util::copy_changed_ranges(ubo, uploaded_, [this, &ubo](size_t offset, size_t size) {
+        std::memcpy(static_cast<char*>(BufferHandle::mapped_) + offset, reinterpret_cast<const char*>(&ubo) + offset, size);
+    });
 }
 
 template<typename UBO>
@@ -57,30 +48,6 @@ SingleUniformBlock<UBO>::SingleUniformBlock(const Window& window, VkBuffer buffe
     : BufferHandle{ window, buffer, BufferSize, 1u }
 {}
 
-template<typename UBO>
-VkDescriptorSetLayoutBinding SingleUniformBlock<UBO>::initDescriptorSetLayoutBinding(VkShaderStageFlagBits type, uint32_t binding)
-{
-    VkDescriptorSetLayoutBinding dslb = {};
-    dslb.binding            = binding;
-    dslb.descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    dslb.descriptorCount    = 1;
-    dslb.stageFlags         = type;
-    dslb.pImmutableSamplers = nullptr;
-    return dslb;
-}
-
-template<typename UBO>
-VkDescriptorSetLayoutCreateInfo SingleUniformBlock<UBO>::initDescriptorSetLayoutCreateInfo(const VkDescriptorSetLayoutBinding& dslb)
-{
-    VkDescriptorSetLayoutCreateInfo dslci = {};
-    dslci.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO; 
-    dslci.pNext        = nullptr;
-    dslci.flags        = 0;
-    dslci.bindingCount = 1;
-    dslci.pBindings    = &dslb;
-    return dslci;
-}
-
 } // namespace details
 
 template<typename UBO>
@@ -93,14 +60,22 @@ DLL_EXPORT Ptr<UniformBlock<UBO>> UniformBlock<UBO>::create(impl::GlslShader& sh
 template<typename UBO>
 DLL_EXPORT void UniformBlock<UBO>::update()
 {
-    uniform_blocks_[current_block_]->update();
-    current_block_ = (current_block_ + 1) % blocks_count_;
+    TRACE_ZONE("UniformBlock::update");
+    // only the copy of the frame recorded next is bound, the others catch up on the ranges they missed in their turn;
+    // copies never written yet get everything so that no frame binds uninitialized memory
+    const auto& window = dynamic_cast<Window&>(Renderer::getWindow());
+    impl::UniformBlock<UBO>::uploaded_bytes_ = 0;
+    for (uint32_t i = 0; i != uniform_blocks_.size(); ++i) {
+        if (i == window.currentFrame() || !uniform_blocks_[i]->initialized()) {
+            impl::UniformBlock<UBO>::uploaded_bytes_ += uniform_blocks_[i]->upload(ubo_);
+        }
+    }
 }
 
 template<typename UBO>
 DLL_EXPORT UBO& UniformBlock<UBO>::get()
 {
-    return uniform_blocks_[current_block_]->get();
+    return ubo_;
 }
 
 template<typename UBO>
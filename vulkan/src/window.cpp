@@ -1,6 +1,11 @@
+#include <chrono>
+
 #define GLFW_INCLUDE_VULKAN
 #include <glfw/glfw3.h>
 
+#include "startup_profile.hpp"
+#include "trace.hpp"
+
 #include "vulkan/command_queue.hpp"
 #include "vulkan/renderer.hpp"
 #include "vulkan/window.hpp"
@@ -10,10 +15,15 @@ namespace vulkan {
 DLL_EXPORT Ptr<Window> Window::create(uint32_t width, uint32_t height, std::string_view title) noexcept
 {
     const auto frame_count = *Config::instance().get<uint32_t>("vk_framebuffers");
-    auto window = Ptr<Window>{ new Window{ frame_count, width, height, title.data() }};
-    if (!window->window_) {
+    const auto headless = Config::instance().get<bool>("headless").value_or(false);
+    auto window = Ptr<Window>{ new Window{ frame_count, width, height, title.data(), headless }};
+    if (!headless && !window->window_) {
         return util::handle_error() << getGlfwErrorDescription();
     }
+    // without a usable cache directory shaders are compiled on every launch
+    if (const auto cache_dir = Config::instance().get<std::string>("shader_cache")) {
+        window->spirv_cache_ = details::SpirvCache::create(*cache_dir);
+    }
     return window;
 }
 
@@ -34,6 +44,15 @@ DLL_EXPORT Window::~Window()
         if (swapchain_) {
             vkDestroySwapchainKHR(device_, swapchain_, nullptr);
         }
+        pipeline_libraries_.reset();
+        if (pipeline_cache_) {
+            if (!savePipelineCache()) {
+                IGNORE(util::handle_error() << "Failed to save " << pipeline_cache_path_);
+            }
+            vkDestroyPipelineCache(device_, pipeline_cache_, nullptr);
+        }
+        descriptor_allocator_.reset();
+        gpu_profiler_.reset();
         vkDestroyDevice(device_, nullptr);
     }
     if (instance_) {
@@ -46,34 +65,80 @@ DLL_EXPORT Window::~Window()
 
 DLL_EXPORT void Window::swapFramebuffers(impl::CommandQueue& queue)
 {
-    static uint32_t current_frame = 0;
+    TRACE_ZONE("Window::swapFramebuffers");
     constexpr auto render_timeout = std::numeric_limits<uint64_t>::max();
-    VULKAN_IF_ERROR_RETURN_VOID(vkWaitForFences(device_, 1, &fences_[current_frame], VK_TRUE, render_timeout));
-
     auto& q = dynamic_cast<CommandQueue&>(queue);
-    q.acquireNextImage(image_available_semaphores_[current_frame]);
-    VULKAN_IF_ERROR_RETURN_VOID(vkResetFences(device_, 1, &fences_[current_frame]));
+    const auto waited_us = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    const auto fence_wait_start = std::chrono::steady_clock::now();
+    VULKAN_IF_ERROR_RETURN_VOID(vkWaitForFences(device_, 1, &fences_[current_frame_], VK_TRUE, render_timeout));
+    q.frame_stats_.fence_wait_us += waited_us(fence_wait_start);
+    if (!descriptor_allocator_->beginFrame(current_frame_)) {
+        IGNORE(util::handle_error());
+        return;
+    }
 
+    if (headless_) {
+        // offscreen images are rendered in turn, there is nothing to acquire or present
+        q.current_image_index_ = current_frame_;
+    }
+    else {
+        q.acquireNextImage(image_available_semaphores_[current_frame_]);
+    }
+    VULKAN_IF_ERROR_RETURN_VOID(vkResetFences(device_, 1, &fences_[current_frame_]));
+
+    q.current_frame_ = current_frame_;
     q.recordCommandBuffer();
 
     VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     VkSubmitInfo si = initSubmitInfo(
-          image_available_semaphores_[current_frame]
-        , render_finished_semaphores_[current_frame]
+          headless_ ? nullptr : &image_available_semaphores_[current_frame_]
+        , headless_ ? nullptr : &render_finished_semaphores_[current_frame_]
         , wait_stage_mask
         , q.command_buffers_[q.current_image_index_]
     );
-    VULKAN_IF_ERROR_RETURN_VOID(vkQueueSubmit(graphic_queue_info_.queue, 1, &si, fences_[current_frame]));
+    VULKAN_IF_ERROR_RETURN_VOID(vkQueueSubmit(graphic_queue_info_.queue, 1, &si, fences_[current_frame_]));
 
-    VkPresentInfoKHR pi = initPresentInfo(render_finished_semaphores_[current_frame], q.current_image_index_);
-    VULKAN_IF_ERROR_RETURN_VOID(vkQueuePresentKHR(present_queue_info_.queue, &pi));
+    if (!headless_) {
+        VkPresentInfoKHR pi = initPresentInfo(render_finished_semaphores_[current_frame_], q.current_image_index_);
+        VULKAN_IF_ERROR_RETURN_VOID(vkQueuePresentKHR(present_queue_info_.queue, &pi));
+    }
+    const auto idle_wait_start = std::chrono::steady_clock::now();
     VULKAN_IF_ERROR_RETURN_VOID(vkDeviceWaitIdle(device_));
+    q.frame_stats_.fence_wait_us += waited_us(idle_wait_start);
 
-    current_frame = (current_frame + 1) % frame_count_;
+    current_frame_ = (current_frame_ + 1) % frame_count_;
 }
 
-Window::Window(uint32_t frame_count, uint32_t width, uint32_t height, std::string_view title) noexcept
-    : impl::Window{ width, height, title, {{GLFW_CLIENT_API, GLFW_NO_API}, {GLFW_RESIZABLE, GLFW_FALSE}} }
+DLL_EXPORT void Window::printMemoryBudget(std::ostream& out) const
+{
+    if (!memory_budget_) {
+        out << "Memory budget: " VK_EXT_MEMORY_BUDGET_EXTENSION_NAME " is not supported\n";
+        return;
+    }
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT };
+    VkPhysicalDeviceMemoryProperties2 properties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2, &budget };
+    vkGetPhysicalDeviceMemoryProperties2(physical_device_, &properties);
+
+    constexpr double MiB = 1024.0 * 1024.0;
+    VkDeviceSize usage = 0;
+    out << "Memory budget:\n";
+    for (uint32_t i = 0; i != properties.memoryProperties.memoryHeapCount; ++i) {
+        const auto& heap = properties.memoryProperties.memoryHeaps[i];
+        usage += budget.heapUsage[i];
+        out << "  heap " << i << ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? " (device local)" : "")
+            << ": " << budget.heapUsage[i] / MiB << " MiB used of " << budget.heapBudget[i] / MiB << " MiB budget, "
+            << heap.size / MiB << " MiB size\n";
+    }
+    // the usage includes swapchain images and whatever else the driver allocates for the process
+    const auto tracked = MemoryStats::instance().total(MemoryStats::Heap::Device).current;
+    out << "  tracked by MemoryStats: " << tracked / MiB << " MiB, untracked: " << (usage > tracked ? usage - tracked : 0) / MiB << " MiB\n";
+}
+
+Window::Window(uint32_t frame_count, uint32_t width, uint32_t height, std::string_view title, bool headless) noexcept
+    : impl::Window{ width, height, title, {{GLFW_CLIENT_API, GLFW_NO_API}, {GLFW_RESIZABLE, GLFW_FALSE}}, headless }
     , frame_count_{ frame_count }
 {}
 
@@ -84,31 +149,40 @@ void Window::setInstance(VkInstance instance)
 
 bool Window::createSurface(const Application& application)
 {
+    if (headless_) {
+        return true;
+    }
     VULKAN_IF_ERROR_RETURN(glfwCreateWindowSurface(instance_, window_.get(), nullptr, &surface_));
     return true;
 }
 
 bool Window::createDevice(const Application& application)
 {
-    const auto physical_devices = getPhysicalDevices(instance_);
-    if (!physical_devices) {
-        return util::handle_error();
-    }
-    const auto physical_device = choosePhysicalDevice(*physical_devices);
-    if (!physical_device) {
-        return util::handle_error();
+    {
+        const auto stage = StartupProfile::instance().stage("physical device selection");
+        const auto physical_devices = getPhysicalDevices(instance_);
+        if (!physical_devices) {
+            return util::handle_error();
+        }
+        const auto physical_device = choosePhysicalDevice(*physical_devices);
+        if (!physical_device) {
+            return util::handle_error();
+        }
+        physical_device_ = *physical_device;
     }
-    physical_device_ = *physical_device;
 
     VkPhysicalDeviceProperties physical_device_props = {};
     vkGetPhysicalDeviceProperties(physical_device_, &physical_device_props);
     std::cout << "Using physical device " << physical_device_props.deviceName << '\n';
 
-    const auto extensions = Config::instance().get<std::vector, std::string>("vk_device_extensions");
+    auto extensions = Config::instance().get<std::vector, std::string>("vk_device_extensions");
+    if (extensions && headless_) {
+        std::erase_if(*extensions, isPresentationExtension);
+    }
     if (!extensions || !checkPhysicalDeviceExtensions(*extensions)) {
         return util::handle_error();
     }
-    const auto dev_exts = util::transform_each<const char*>(*extensions, util::string_cstr<char>);
+    auto dev_exts = util::transform_each<const char*>(*extensions, util::string_cstr<char>);
 
     const auto queue_family_props = getQueueFamilyProperties();
     std::optional<uint32_t> graphic_queue_family_index{}, present_queue_family_index{};
@@ -117,7 +191,7 @@ bool Window::createDevice(const Application& application)
             graphic_queue_family_index = i;
             continue;
         }
-        if (!present_queue_family_index) {
+        if (!present_queue_family_index && !headless_) {
             VkBool32 presentation_supported = VK_FALSE;
             if (const auto result = vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, i, surface_, &presentation_supported);
                 result == VK_SUCCESS && presentation_supported == VK_TRUE) {
@@ -125,6 +199,9 @@ bool Window::createDevice(const Application& application)
             }
         }
     }
+    if (headless_) {
+        present_queue_family_index = graphic_queue_family_index;
+    }
     if (!graphic_queue_family_index || !present_queue_family_index) {
         return util::handle_error();
     }
@@ -132,7 +209,10 @@ bool Window::createDevice(const Application& application)
     graphic_queue_info_.family_index = *graphic_queue_family_index;
     present_queue_info_.family_index = *present_queue_family_index;
 
-    std::vector<uint32_t> queue_family_indices{ graphic_queue_info_.family_index, present_queue_info_.family_index };
+    std::vector<uint32_t> queue_family_indices{ graphic_queue_info_.family_index };
+    if (present_queue_info_.family_index != graphic_queue_info_.family_index) {
+        queue_family_indices.push_back(present_queue_info_.family_index);
+    }
     std::vector<float> queue_priorities(queue_family_indices.size(), 0.f);
 
     std::vector<VkDeviceQueueCreateInfo> dqcis{};
@@ -144,17 +224,114 @@ bool Window::createDevice(const Application& application)
     VkPhysicalDeviceFeatures features = {};
     vkGetPhysicalDeviceFeatures(physical_device_, &features);
 
-    VkPhysicalDeviceCoherentMemoryFeaturesAMD device_coherent_memory = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COHERENT_MEMORY_FEATURES_AMD, nullptr, VK_TRUE };
+    auto descriptor_indexing = getDescriptorIndexingFeatures();
+    const auto bindless_descriptor_count = getBindlessDescriptorCount();
+    if (!descriptor_indexing || !bindless_descriptor_count) {
+        return util::handle_error();
+    }
+    bindless_descriptor_count_ = *bindless_descriptor_count;
+
+    // optional, pipelines are created in one piece without it
+    auto pipeline_library = getGraphicsPipelineLibraryFeatures();
+    if (pipeline_library) {
+        for (const auto* ext : { VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME }) {
+            if (std::ranges::find(*extensions, ext) == extensions->end()) {
+                dev_exts.push_back(ext);
+            }
+        }
+        descriptor_indexing->pNext = &pipeline_library.value();
+    }
+
+    // optional, only read for the memory reports
+    const auto available_extensions = getAvailablePhysicalDeviceExtensionNames();
+    memory_budget_ = available_extensions && std::ranges::find(*available_extensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) != available_extensions->end();
+    if (memory_budget_ && std::ranges::find(*extensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == extensions->end()) {
+        dev_exts.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    // gl_BaseInstance and gl_DrawID select the per-draw data in the vertex shader
+    VkPhysicalDeviceShaderDrawParametersFeatures shader_draw_parameters = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES, &descriptor_indexing.value(), VK_TRUE };
+    VkPhysicalDeviceCoherentMemoryFeaturesAMD device_coherent_memory = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COHERENT_MEMORY_FEATURES_AMD, &shader_draw_parameters, VK_TRUE };
     VkDeviceCreateInfo dci = initDeviceCreateInfo(dqcis, dev_exts, features, device_coherent_memory);
     VULKAN_IF_ERROR_RETURN(vkCreateDevice(physical_device_, &dci, nullptr, &device_));
 
     vkGetDeviceQueue(device_, graphic_queue_info_.family_index, 0, &graphic_queue_info_.queue);
     vkGetDeviceQueue(device_, present_queue_info_.family_index, 0, &present_queue_info_.queue);
+
+    descriptor_allocator_ = DescriptorAllocator::create(device_, frame_count_, getUpdateAfterBindDescriptorLimit());
+    const auto cache_stage = StartupProfile::instance().stage("pipeline cache");
+    if (!createPipelineCache()) {
+        return util::handle_error();
+    }
+    if (pipeline_library) {
+        pipeline_libraries_ = details::PipelineLibraryCache::create(device_, pipeline_cache_);
+    }
+    if (Config::instance().get<bool>("gpu_profiler").value_or(false)) {
+        gpu_profiler_ = details::GpuProfiler::create(physical_device_, device_, graphic_queue_info_.family_index, frame_count_);
+    }
     return true;
 }
 
+bool Window::createPipelineCache()
+{
+    if (const auto cache_dir = Config::instance().get<std::string>("shader_cache")) {
+        pipeline_cache_path_ = std::filesystem::path{ *cache_dir } / "pipeline_cache.bin";
+    }
+    const auto cache_data = loadPipelineCache();
+    pipeline_cache_warm_ = !cache_data.empty();
+    VkPipelineCacheCreateInfo pcci = initPipelineCacheCreateInfo(cache_data);
+    VULKAN_IF_ERROR_RETURN(vkCreatePipelineCache(device_, &pcci, nullptr, &pipeline_cache_));
+    return true;
+}
+
+std::vector<char> Window::loadPipelineCache() const
+{
+    if (pipeline_cache_path_.empty()) {
+        return {};
+    }
+    auto data = util::read_binary_file<char>(pipeline_cache_path_);
+    if (!data) {
+        return {};
+    }
+
+    // data from another driver or device is not an error, it is thrown away and the cache starts over
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(physical_device_, &properties);
+    VkPipelineCacheHeaderVersionOne header = {};
+    if (data->size() < sizeof(header)) {
+        return {};
+    }
+    std::memcpy(&header, data->data(), sizeof(header));
+    if (header.headerSize < sizeof(header)
+        || header.headerSize > data->size()
+        || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        || header.vendorID != properties.vendorID
+        || header.deviceID != properties.deviceID
+        || std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        std::cout << "Pipeline cache " << pipeline_cache_path_ << " does not match the device, ignored\n";
+        return {};
+    }
+    return std::move(*data);
+}
+
+bool Window::savePipelineCache() const
+{
+    if (pipeline_cache_path_.empty()) {
+        return true;
+    }
+    size_t size = 0;
+    VULKAN_IF_ERROR_RETURN(vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr));
+    std::vector<char> data(size);
+    VULKAN_IF_ERROR_RETURN(vkGetPipelineCacheData(device_, pipeline_cache_, &size, data.data()));
+    return util::write_binary_file(pipeline_cache_path_, data.data(), size);
+}
+
+
 bool Window::createSwapchain(const Application& application)
 {
+    if (headless_) {
+        return true;
+    }
     VkSurfaceCapabilitiesKHR surface_capabilities = {};
     VULKAN_IF_ERROR_RETURN(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities));
 
@@ -189,6 +366,11 @@ bool Window::createSyncObjects(const Application& application)
     return true;
 }
 
+bool Window::isPresentationExtension(std::string_view name)
+{
+    return name.ends_with("_surface") || name == VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+}
+
 Opt<std::vector<VkPhysicalDevice>> Window::getPhysicalDevices(VkInstance instance)
 {
     uint32_t count = 0;
@@ -230,6 +412,72 @@ bool Window::checkPhysicalDeviceExtensions(const std::vector<std::string>& exten
     return true;
 }
 
+Opt<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT> Window::getGraphicsPipelineLibraryFeatures()
+{
+    const auto available_extensions = getAvailablePhysicalDeviceExtensionNames();
+    if (!available_extensions
+        || std::ranges::find(*available_extensions, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) == available_extensions->end()
+        || std::ranges::find(*available_extensions, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) == available_extensions->end()) {
+        return std::nullopt;
+    }
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT supported = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT };
+    VkPhysicalDeviceFeatures2 features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, &supported };
+    vkGetPhysicalDeviceFeatures2(physical_device_, &features);
+    if (!supported.graphicsPipelineLibrary) {
+        return std::nullopt;
+    }
+    return VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT, nullptr, VK_TRUE };
+}
+
+Opt<VkPhysicalDeviceDescriptorIndexingFeaturesEXT> Window::getDescriptorIndexingFeatures()
+{
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT supported = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT };
+    VkPhysicalDeviceFeatures2 features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, &supported };
+    vkGetPhysicalDeviceFeatures2(physical_device_, &features);
+    if (!supported.runtimeDescriptorArray
+        || !supported.descriptorBindingPartiallyBound
+        || !supported.descriptorBindingVariableDescriptorCount
+        || !supported.descriptorBindingStorageBufferUpdateAfterBind
+        || !supported.shaderStorageBufferArrayNonUniformIndexing) {
+        return util::handle_error() << "Bindless storage buffers are not supported";
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT difs = {};
+    difs.sType                                         = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    difs.pNext                                         = nullptr;
+    difs.shaderStorageBufferArrayNonUniformIndexing    = VK_TRUE;
+    difs.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    difs.descriptorBindingPartiallyBound               = VK_TRUE;
+    difs.descriptorBindingVariableDescriptorCount      = VK_TRUE;
+    difs.runtimeDescriptorArray                        = VK_TRUE;
+    return difs;
+}
+
+uint32_t Window::getUpdateAfterBindDescriptorLimit()
+{
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexing = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT };
+    VkPhysicalDeviceProperties2 properties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, &indexing };
+    vkGetPhysicalDeviceProperties2(physical_device_, &properties);
+    return indexing.maxUpdateAfterBindDescriptorsInAllPools;
+}
+
+Opt<uint32_t> Window::getBindlessDescriptorCount()
+{
+    const auto count = Config::instance().get<uint32_t>("vk_bindless_descriptors");
+    if (!count) {
+        return util::handle_error();
+    }
+
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexing = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT };
+    VkPhysicalDeviceProperties2 properties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, &indexing };
+    vkGetPhysicalDeviceProperties2(physical_device_, &properties);
+    return std::min({
+          *count
+        , indexing.maxPerStageDescriptorUpdateAfterBindStorageBuffers
+        , indexing.maxDescriptorSetUpdateAfterBindStorageBuffers
+    });
+}
+
 std::vector<VkQueueFamilyProperties> Window::getQueueFamilyProperties()
 {
     uint32_t count = 0;
@@ -325,21 +573,21 @@ VkSwapchainCreateInfoKHR Window::initSwapchainCreateInfo(
 }
 
 VkSubmitInfo Window::initSubmitInfo(
-      VkSemaphore&                image_available_semaphore
-    , VkSemaphore&                render_finished_semaphore
+      VkSemaphore*                image_available_semaphore
+    , VkSemaphore*                render_finished_semaphore
     , const VkPipelineStageFlags& wait_dst_stage_mask
     , const VkCommandBuffer&      command_buffer)
 {
     VkSubmitInfo si = {};
     si.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     si.pNext                = nullptr;
-    si.waitSemaphoreCount   = 1;
-    si.pWaitSemaphores      = &image_available_semaphore;
+    si.waitSemaphoreCount   = image_available_semaphore ? 1 : 0;
+    si.pWaitSemaphores      = image_available_semaphore;
     si.pWaitDstStageMask    = &wait_dst_stage_mask;
     si.commandBufferCount   = 1;
     si.pCommandBuffers      = &command_buffer;
-    si.signalSemaphoreCount = 1;
-    si.pSignalSemaphores    = &render_finished_semaphore;
+    si.signalSemaphoreCount = render_finished_semaphore ? 1 : 0;
+    si.pSignalSemaphores    = render_finished_semaphore;
     return si;
 }
 
@@ -357,4 +605,15 @@ VkPresentInfoKHR Window::initPresentInfo(VkSemaphore& render_finished_semaphore,
     return pi;
 }
 
+VkPipelineCacheCreateInfo Window::initPipelineCacheCreateInfo(const std::vector<char>& initial_data)
+{
+    VkPipelineCacheCreateInfo pcci = {};
+    pcci.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pcci.pNext           = nullptr;
+    pcci.flags           = 0;
+    pcci.initialDataSize = initial_data.size();
+    pcci.pInitialData    = initial_data.empty() ? nullptr : initial_data.data();
+    return pcci;
+}
+
 } // namespace vulkan
\ No newline at end of file